@@ -83,6 +83,10 @@ class MikroxmlConan(ConanFile):
 	def package_info(self):
 		self.cpp_info.libs = [self.name]
 
+		# parse_document_parallel() uses std::thread
+		if self.settings.os in ["Linux", "FreeBSD"]:
+			self.cpp_info.system_libs = ["pthread"]
+
 	def package_id(self):
 		# change package id only when minor or major version changes, i.e. when ABI breaks
 		self.info.requires.minor_mode()
@@ -0,0 +1,4 @@
+include $(config_dir)dev.mk
+
+# collect parser statistics, so that the tests cover the counting code
+this_cxxflags += -DMIKROXML_STATS
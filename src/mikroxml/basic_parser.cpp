@@ -0,0 +1,1379 @@
+/*
+MIT License
+
+Copyright (c) 2017-2026 Ivan Gagis
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* ================ LICENSE END ================ */
+
+#include "basic_parser.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <sstream>
+
+#if defined(__SSE2__)
+#	include <emmintrin.h>
+#endif
+#if defined(__AVX2__)
+#	include <immintrin.h>
+#endif
+
+using namespace mikroxml;
+
+namespace {
+constexpr auto buffer_reserve_size = 0x100; // 4kb
+constexpr auto ref_char_buffer_reserve_size = 10;
+} // namespace
+
+namespace {
+#if defined(__SSE2__)
+unsigned count_trailing_zeros(unsigned mask)
+{
+	return unsigned(__builtin_ctz(mask));
+}
+
+#endif
+
+// returns the character of the predefined entity or '\0' if there is no such predefined entity
+char find_predefined_entity(std::string_view entity_name) noexcept
+{
+	using namespace std::string_view_literals;
+
+	switch (entity_name.size()) {
+		case 2:
+			if (entity_name == "lt"sv) {
+				return '<';
+			} else if (entity_name == "gt"sv) {
+				return '>';
+			}
+			break;
+		case 3:
+			if (entity_name == "amp"sv) {
+				return '&';
+			}
+			break;
+		case 4:
+			if (entity_name[0] == 'q') {
+				if (entity_name == "quot"sv) {
+					return '"';
+				}
+			} else if (entity_name == "apos"sv) {
+				return '\'';
+			}
+			break;
+		default:
+			break;
+	}
+	return '\0';
+}
+
+constexpr char32_t max_code_point = 0x10ffff;
+constexpr char32_t invalid_code_point = ~char32_t(0);
+
+constexpr uint8_t not_a_digit = 0xff;
+
+constexpr std::array<uint8_t, 0x100> make_hex_digit_table() noexcept
+{
+	std::array<uint8_t, 0x100> table{};
+	for (auto& v : table) {
+		v = not_a_digit;
+	}
+	for (unsigned i = 0; i != 10; ++i) {
+		table['0' + i] = uint8_t(i);
+	}
+	for (unsigned i = 0; i != 6; ++i) {
+		table['a' + i] = uint8_t(10 + i);
+		table['A' + i] = uint8_t(10 + i);
+	}
+	return table;
+}
+
+constexpr auto hex_digit_table = make_hex_digit_table();
+
+// decodes the number of a numeric character reference, i.e. the part after '#', e.g. "x20" or "32",
+// returns invalid_code_point if the number is malformed or is not a valid XML character code point
+char32_t decode_numeric_ref(std::string_view number) noexcept
+{
+	unsigned base = 10;
+	if (!number.empty() && number.front() == 'x') {
+		base = 0x10;
+		number.remove_prefix(1);
+	}
+
+	if (number.empty()) {
+		return invalid_code_point;
+	}
+
+	char32_t code_point = 0;
+	for (char c : number) {
+		auto digit = hex_digit_table[uint8_t(c)];
+		if (digit >= base) {
+			return invalid_code_point;
+		}
+		code_point = code_point * base + digit;
+
+		// checking on each digit also guards against overflow
+		if (code_point > max_code_point) {
+			return invalid_code_point;
+		}
+	}
+
+	// null character and UTF-16 surrogates are not allowed in XML
+	if (code_point == 0 || (code_point >= 0xd800 && code_point <= 0xdfff)) {
+		return invalid_code_point;
+	}
+
+	return code_point;
+}
+
+void append_utf8(std::pmr::vector<char>& buf, char32_t c)
+{
+	// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers)
+	if (c < 0x80) {
+		buf.push_back(char(c));
+	} else if (c < 0x800) {
+		buf.push_back(char(0xc0 | (c >> 6)));
+		buf.push_back(char(0x80 | (c & 0x3f)));
+	} else if (c < 0x10000) {
+		buf.push_back(char(0xe0 | (c >> 12)));
+		buf.push_back(char(0x80 | ((c >> 6) & 0x3f)));
+		buf.push_back(char(0x80 | (c & 0x3f)));
+	} else {
+		buf.push_back(char(0xf0 | (c >> 18)));
+		buf.push_back(char(0x80 | ((c >> 12) & 0x3f)));
+		buf.push_back(char(0x80 | ((c >> 6) & 0x3f)));
+		buf.push_back(char(0x80 | (c & 0x3f)));
+	}
+	// NOLINTEND(cppcoreguidelines-avoid-magic-numbers)
+}
+
+unsigned count_new_lines(const char* begin, const char* end)
+{
+	size_t ret = 0;
+
+#if defined(__SSE2__)
+	{
+		constexpr auto block_size = sizeof(__m128i);
+
+		// the per-byte counters overflow after 255 blocks
+		constexpr size_t max_blocks_per_batch = 0xff;
+
+		const auto vnl = _mm_set1_epi8('\n');
+
+		// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+		while (size_t(end - begin) >= block_size) {
+			auto counters = _mm_setzero_si128();
+
+			// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+			for (size_t i = 0; i != max_blocks_per_batch && size_t(end - begin) >= block_size; ++i, begin += block_size) {
+				// NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+				auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+
+				// matching bytes are -1, so subtracting them increments the counters
+				counters = _mm_sub_epi8(counters, _mm_cmpeq_epi8(block, vnl));
+			}
+
+			// sum up the per-byte counters
+			auto sums = _mm_sad_epu8(counters, _mm_setzero_si128());
+			ret += size_t(_mm_cvtsi128_si32(sums)) + size_t(_mm_extract_epi16(sums, 4));
+		}
+	}
+#endif
+
+	return unsigned(ret + size_t(std::count(begin, end, '\n')));
+}
+} // namespace
+
+malformed_xml::malformed_xml(unsigned line_number, const std::string& message) :
+	std::logic_error([line_number, &message]() {
+		std::stringstream ss;
+		ss << message << " line: " << line_number;
+		return ss.str();
+	}()),
+	line_number(line_number)
+{}
+
+malformed_xml::malformed_xml(const text_position& position, const std::string& message) :
+	std::logic_error([&position, &message]() {
+		std::stringstream ss;
+		ss << message << " line: " << position.line << " column: " << position.column()
+		   << " offset: " << position.offset;
+		return ss.str();
+	}()),
+	line_number(position.line),
+	column_number(position.column()),
+	byte_offset(position.offset)
+{}
+
+constexpr std::array<uint8_t, 256> parser_base::make_char_classes() noexcept
+{
+	std::array<uint8_t, 256> ret = {};
+
+	auto add = [&ret](std::string_view chars, uint8_t cls) {
+		for (auto c : chars) {
+			ret[uint8_t(c)] |= cls;
+		}
+	};
+
+	using namespace std::string_view_literals;
+
+	constexpr auto whitespaces = " \t\n\r"sv;
+
+	add(whitespaces, char_class::whitespace);
+
+	add(whitespaces, char_class::tag_name_special);
+	add(">/[-"sv, char_class::tag_name_special);
+
+	add(whitespaces, char_class::tag_name_end);
+	add(">/"sv, char_class::tag_name_end);
+
+	add(whitespaces, char_class::attribute_name_end);
+	add("="sv, char_class::attribute_name_end);
+
+	return ret;
+}
+
+const std::array<uint8_t, 256> parser_base::char_classes = parser_base::make_char_classes();
+
+bool parser_base::starts_with(utki::span<const char> span, std::string_view str) noexcept
+{
+	if (span.size() < str.size()) {
+		return false;
+	}
+
+	for (size_t i = 0; i != str.size(); ++i) {
+		if (str[i] != span[i]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool parser_base::starts_with(const char* p, const char* end, std::string_view str) noexcept
+{
+	// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+	return size_t(end - p) >= str.size() && std::equal(str.begin(), str.end(), p);
+}
+
+/**
+ * @brief Find first occurrence of any of three characters.
+ * Scans the range for the first character which equals to any of the given characters.
+ * @param p - start of the range.
+ * @param end - end of the range.
+ * @param c1 - character to search for.
+ * @param c2 - character to search for.
+ * @param c3 - character to search for.
+ * @return pointer to the found character or 'end' if nothing found.
+ */
+const char* parser_base::find_first_of(
+	const char* p, //
+	const char* end,
+	char c1,
+	char c2,
+	char c3
+) noexcept
+{
+#if defined(__AVX2__)
+	{
+		constexpr auto block_size = sizeof(__m256i);
+
+		const auto v1 = _mm256_set1_epi8(c1);
+		const auto v2 = _mm256_set1_epi8(c2);
+		const auto v3 = _mm256_set1_epi8(c3);
+
+		// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+		for (; size_t(end - p) >= block_size; p += block_size) {
+			// NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+			auto block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+
+			auto mask = unsigned(_mm256_movemask_epi8(_mm256_or_si256(
+				_mm256_or_si256(_mm256_cmpeq_epi8(block, v1), _mm256_cmpeq_epi8(block, v2)),
+				_mm256_cmpeq_epi8(block, v3)
+			)));
+
+			if (mask != 0) {
+				// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+				return p + count_trailing_zeros(mask);
+			}
+		}
+	}
+#endif
+
+#if defined(__SSE2__)
+	{
+		constexpr auto block_size = sizeof(__m128i);
+
+		const auto v1 = _mm_set1_epi8(c1);
+		const auto v2 = _mm_set1_epi8(c2);
+		const auto v3 = _mm_set1_epi8(c3);
+
+		// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+		for (; size_t(end - p) >= block_size; p += block_size) {
+			// NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+			auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+
+			auto mask = unsigned(_mm_movemask_epi8(
+				_mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(block, v1), _mm_cmpeq_epi8(block, v2)), _mm_cmpeq_epi8(block, v3))
+			));
+
+			if (mask != 0) {
+				// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+				return p + count_trailing_zeros(mask);
+			}
+		}
+	}
+#endif
+
+	// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+	for (; p != end; ++p) {
+		auto c = *p;
+		if (c == c1 || c == c2 || c == c3) {
+			return p;
+		}
+	}
+	return end;
+}
+
+// find first occurrence of the character
+const char* parser_base::find(const char* p, const char* end, char c) noexcept
+{
+	auto found = static_cast<const char*>(std::memchr(p, c, size_t(end - p)));
+	if (!found) {
+		return end;
+	}
+	return found;
+}
+
+// find first occurrence of the string
+const char* parser_base::find(const char* p, const char* end, std::string_view str) noexcept
+{
+	// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+	auto pos = std::string_view(p, size_t(end - p)).find(str);
+	if (pos == std::string_view::npos) {
+		return end;
+	}
+	// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+	return p + pos;
+}
+
+/**
+ * @brief Skip run of ordinary characters.
+ * @param i - iterator to start from. Will be moved to the first special character
+ *            or to the end of the range.
+ * @param e - end of the range.
+ * @param c1 - special character.
+ * @param c2 - special character.
+ * @param c3 - special character.
+ */
+void parser_base::skip_to_first_of(
+	utki::span<const char>::iterator& i,
+	utki::span<const char>::iterator& e,
+	char c1,
+	char c2,
+	char c3
+)
+{
+	if (i == e) {
+		return;
+	}
+
+	const char* begin = &*i;
+	// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+	const char* end = begin + std::distance(i, e);
+
+	i += std::distance(begin, find_first_of(begin, end, c1, c2, c3));
+}
+
+/**
+ * @brief Skip to the character.
+ * @param i - iterator to start from. Will be moved to the first occurrence
+ *            of the character or to the end of the range.
+ * @param e - end of the range.
+ * @param c - character to skip to.
+ */
+void parser_base::skip_to(utki::span<const char>::iterator& i, utki::span<const char>::iterator& e, char c)
+{
+	if (i == e) {
+		return;
+	}
+
+	const char* begin = &*i;
+	// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+	const char* end = begin + std::distance(i, e);
+
+	i += std::distance(begin, find(begin, end, c));
+}
+
+text_position parser_base::advance(text_position position, const char* begin, const char* end) noexcept
+{
+	// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+	auto size = size_t(end - begin);
+
+	auto num_new_lines = count_new_lines(begin, end);
+	if (num_new_lines != 0) {
+		position.line += num_new_lines;
+
+		// find beginning of the last line
+		auto last_line = std::string_view(begin, size).rfind('\n') + 1;
+		position.line_offset = position.offset + last_line;
+	}
+
+	position.offset += size;
+	return position;
+}
+
+namespace {
+std::pmr::memory_resource* get_memory(const parser_options& options) noexcept
+{
+	if (options.memory) {
+		return options.memory;
+	}
+	return std::pmr::get_default_resource();
+}
+} // namespace
+
+parser_base::parser_base(const parser_options& options) :
+	buf(get_memory(options)),
+	name(get_memory(options)),
+	ref_char_buf(get_memory(options)),
+	doctype_entities(get_memory(options)),
+	options(options),
+	input_decoder(get_memory(options))
+{
+	this->buf.reserve(buffer_reserve_size);
+	this->name.reserve(buffer_reserve_size);
+	this->ref_char_buf.reserve(ref_char_buffer_reserve_size);
+}
+
+void parser_base::reset() noexcept
+{
+	this->cur_state = state::idle;
+	this->buf.clear();
+	this->name.clear();
+	this->ref_char_buf.clear();
+	this->attr_name_view = {};
+	this->attr_value_quote_char = 0;
+	this->state_after_ref_char = state::idle;
+	this->chunk_position = {};
+	this->depth = 0;
+	this->entity_expansion_size = 0;
+	this->doctype_entities.clear();
+	this->cur_name_id = name_table::unknown;
+	this->input_decoder.reset();
+	this->collected_stats = {};
+}
+
+parser_base& parser_base::operator=(parser_base&& other)
+{
+	if (this == &other) {
+		return *this;
+	}
+
+	// the pmr containers do not take over the memory resource of the other parser,
+	// the moved data is reallocated from this parser's resource if the resources differ
+	auto memory = this->options.memory;
+
+	this->cur_state = other.cur_state;
+	this->buf = std::move(other.buf);
+	this->name = std::move(other.name);
+	this->ref_char_buf = std::move(other.ref_char_buf);
+	this->attr_name_view = other.attr_name_view;
+	this->attr_value_quote_char = other.attr_value_quote_char;
+	this->state_after_ref_char = other.state_after_ref_char;
+	this->chunk_position = other.chunk_position;
+	this->depth = other.depth;
+	this->entity_expansion_size = other.entity_expansion_size;
+	this->doctype_entities = std::move(other.doctype_entities);
+	this->options = std::move(other.options);
+	this->options.memory = memory;
+	this->input_decoder = std::move(other.input_decoder);
+	this->cur_name_id = other.cur_name_id;
+	this->collected_stats = other.collected_stats;
+
+	return *this;
+}
+
+void parser_base::update_peak_capacities() noexcept
+{
+	if constexpr (stats_enabled) {
+		auto& stats = this->collected_stats;
+		stats.peak_buf_capacity = std::max(stats.peak_buf_capacity, this->buf.capacity());
+		stats.peak_name_capacity = std::max(stats.peak_name_capacity, this->name.capacity());
+		stats.peak_ref_char_buf_capacity = std::max(stats.peak_ref_char_buf_capacity, this->ref_char_buf.capacity());
+	}
+}
+
+std::string_view parser_stats::state_name(size_t state) noexcept
+{
+	// same order as the parser_base::state enumerators
+	constexpr std::array<std::string_view, num_states> names = {
+		{"idle",
+		 "tag",
+		 "tag_seek_gt",
+		 "tag_empty",
+		 "declaration",
+		 "declaration_end",
+		 "comment",
+		 "comment_end",
+		 "comment_terminator",
+		 "attributes",
+		 "attribute_name",
+		 "attribute_seek_to_equals",
+		 "attribute_seek_to_value",
+		 "attribute_value",
+		 "content",
+		 "ref_char",
+		 "doctype",
+		 "doctype_body",
+		 "doctype_tag",
+		 "doctype_entity_name",
+		 "doctype_entity_seek_to_value",
+		 "doctype_entity_value",
+		 "doctype_skip_tag",
+		 "skip_unknown_exclamation_mark_construct",
+		 "cdata",
+		 "cdata_terminator"}
+	};
+
+	if (state >= names.size()) {
+		return {};
+	}
+	return names[state];
+}
+
+utki::span<const char> parser_base::make_token(
+	std::pmr::vector<char>& buffer,
+	utki::span<const char>::iterator begin,
+	utki::span<const char>::iterator end
+)
+{
+	if (this->options.zero_copy && buffer.empty()) {
+		// the whole token is within the input data
+		return utki::make_span(&*begin, size_t(std::distance(begin, end)));
+	}
+	buffer.insert(std::end(buffer), begin, end);
+	return utki::make_span(buffer.data(), buffer.size());
+}
+
+utki::span<const char> parser_base::attribute_name() const noexcept
+{
+	if (!this->attr_name_view.empty()) {
+		return this->attr_name_view;
+	}
+	return utki::make_span(this->name.data(), this->name.size());
+}
+
+void parser_base::release_input()
+{
+	// the input data is not guaranteed to be valid after feed() returns,
+	// so copy the attribute name which still refers to it
+	if (!this->attr_name_view.empty()) {
+		ASSERT(this->name.empty())
+		this->name.insert(std::end(this->name), std::begin(this->attr_name_view), std::end(this->attr_name_view));
+		this->attr_name_view = {};
+	}
+}
+
+void parser_base::check_name_length(utki::span<const char> name) const
+{
+	if (name.size() > this->options.limits.max_name_length) {
+		throw syntax_error("too long name encountered");
+	}
+}
+
+void parser_base::check_markup_name_length(utki::span<const char> tag_name) const
+{
+	// the tag name includes the '/', '?' or '!' prefix, and can be one of the special words like '!DOCTYPE'
+	size_t max_length = std::max(this->options.limits.max_name_length, doctype_tag_word.size());
+	if (tag_name.size() > 1 && tag_name.size() - 1 > max_length) {
+		throw syntax_error("too long name encountered");
+	}
+}
+
+void parser_base::check_token_length(size_t length) const
+{
+	if (length > this->options.limits.max_token_length) {
+		throw syntax_error("too long text token encountered");
+	}
+}
+
+void parser_base::check_buffered_size() const
+{
+	const auto& limits = this->options.limits;
+
+	if (this->name.size() > limits.max_name_length) {
+		throw syntax_error("too long name encountered");
+	}
+
+	switch (this->cur_state) {
+		case state::tag:
+		case state::doctype_tag:
+			this->check_markup_name_length(utki::make_span(this->buf.data(), this->buf.size()));
+			break;
+		case state::doctype_entity_name:
+			this->check_name_length(utki::make_span(this->buf.data(), this->buf.size()));
+			break;
+		case state::cdata_terminator:
+			// the buffer ends with the "]]" which might be a part of the CDATA terminator
+			this->check_token_length(this->buf.size() - std::min(this->buf.size(), size_t(2)));
+			break;
+		default:
+			this->check_token_length(this->buf.size());
+			break;
+	}
+}
+
+bool parser_base::is_in_content() const noexcept
+{
+	// in CDATA terminator state the buffer ends with ']' characters which might be part of the terminator
+	switch (this->cur_state) {
+		case state::content:
+		case state::cdata:
+			return true;
+		case state::ref_char:
+			return this->state_after_ref_char == state::content;
+		default:
+			return false;
+	}
+}
+
+void parser_base::enter_element()
+{
+	if (this->depth == this->options.limits.max_depth) {
+		throw syntax_error("maximal element nesting depth exceeded");
+	}
+	++this->depth;
+
+	if constexpr (stats_enabled) {
+		++this->collected_stats.num_elements;
+	}
+}
+
+void parser_base::leave_element() noexcept
+{
+	// unmatched end tags are not checked, so the depth is not allowed to go negative
+	if (this->depth != 0) {
+		--this->depth;
+	}
+}
+
+size_t parser_base::content_piece_length(utki::span<const char> content, size_t max_length) noexcept
+{
+	size_t length = std::max(max_length, size_t(1));
+	if (content.size() <= length) {
+		return content.size();
+	}
+
+	// move the piece end back to the UTF-8 character boundary,
+	// so that the next piece does not start with a continuation byte
+	constexpr size_t max_utf8_continuation_bytes = 3;
+	for (size_t ret = length; ret != 0 && length - ret <= max_utf8_continuation_bytes; --ret) {
+		if ((uint8_t(content[ret]) & 0xc0) != 0x80) {
+			return ret;
+		}
+	}
+
+	// the piece is shorter than the character, or the data is not a valid UTF-8
+	return length;
+}
+
+void parser_base::process_parsed_ref_char()
+{
+	this->cur_state = this->state_after_ref_char;
+
+	this->expand_ref_char(utki::make_span(this->ref_char_buf.data(), this->ref_char_buf.size()));
+
+	this->ref_char_buf.clear();
+}
+
+void parser_base::expand_ref_char(utki::span<const char> ref_char)
+{
+	if (ref_char.size() == 0) {
+		return;
+	}
+
+	if (ref_char.size() > this->options.limits.max_ref_length) {
+		throw syntax_error("too long character reference encountered");
+	}
+
+	if (ref_char[0] == '#') { // numeric character reference
+		auto number = std::string_view(std::next(ref_char.data()), ref_char.size() - 1);
+
+		char32_t code_point = decode_numeric_ref(number);
+		if (code_point == invalid_code_point) {
+			throw syntax_error(
+				std::string("unknown numeric character reference encountered: ").append(number)
+			);
+		}
+
+		append_utf8(this->buf, code_point);
+
+		if constexpr (stats_enabled) {
+			++this->collected_stats.num_numeric_refs;
+		}
+	} else { // character name reference
+		auto ref_char_string = std::string_view(ref_char.data(), ref_char.size());
+
+		// DOCTYPE entities take precedence over the predefined ones
+		if (!this->doctype_entities.empty()) {
+			if (auto value = this->doctype_entities.find(ref_char_string)) {
+				this->entity_expansion_size += value->size();
+				if (this->entity_expansion_size > this->options.limits.max_entity_expansion) {
+					throw syntax_error("DOCTYPE entities expansion limit exceeded");
+				}
+				this->buf.insert(std::end(this->buf), std::begin(*value), std::end(*value));
+
+				if constexpr (stats_enabled) {
+					++this->collected_stats.num_doctype_refs;
+				}
+				return;
+			}
+		}
+
+		char c = find_predefined_entity(ref_char_string);
+		if (c == '\0') {
+			std::stringstream ss;
+			ss << "unknown name character reference encountered: " << ref_char_string;
+			throw syntax_error(ss.str());
+		}
+		this->buf.push_back(c);
+
+		if constexpr (stats_enabled) {
+			++this->collected_stats.num_named_refs;
+		}
+	}
+}
+
+void parser_base::add_doctype_entity(utki::span<const char> entity_name, std::pmr::vector<char> value)
+{
+	this->check_name_length(entity_name);
+	this->check_token_length(value.size());
+
+	auto key = std::string_view(entity_name.data(), entity_name.size());
+
+	// first definition of the entity is binding
+	if (this->doctype_entities.find(key)) {
+		return;
+	}
+
+	if (this->doctype_entities.size() >= this->options.limits.max_doctype_entities) {
+		throw syntax_error("too many DOCTYPE entities encountered");
+	}
+
+	this->doctype_entities.add(key, std::move(value));
+}
+
+parser_base::doctype_entity_table& parser_base::doctype_entity_table::operator=(doctype_entity_table&& other)
+{
+	if (this == &other) {
+		return *this;
+	}
+
+	if (this->names.get_allocator() == other.names.get_allocator()) {
+		// the memory is taken over, the names stay in place
+		this->names = std::move(other.names);
+		this->values = std::move(other.values);
+		return *this;
+	}
+
+	this->clear();
+	for (auto& v : other.values) {
+		this->add(v.first, std::move(v.second));
+	}
+	other.clear();
+	return *this;
+}
+
+const std::pmr::vector<char>* parser_base::doctype_entity_table::find(std::string_view name) const
+{
+	auto i = this->values.find(name);
+	if (i == this->values.end()) {
+		return nullptr;
+	}
+	return &i->second;
+}
+
+void parser_base::doctype_entity_table::add(std::string_view name, std::pmr::vector<char> value)
+{
+	ASSERT(!this->find(name))
+
+	const auto& stored_name = this->names.emplace_back(name);
+	this->values.insert(std::make_pair(std::string_view(stored_name), std::move(value)));
+}
+
+void parser_base::doctype_entity_table::clear() noexcept
+{
+	this->values.clear();
+	this->names.clear();
+}
+
+void parser_base::parse_ref_char(utki::span<const char>::iterator& i, utki::span<const char>::iterator& e)
+{
+	for (; i != e; ++i) {
+		switch (*i) {
+			case ';':
+				this->process_parsed_ref_char();
+				return;
+			default:
+				// the error is reported at the first character exceeding the limit, same as by parse_document()
+				if (this->ref_char_buf.size() == this->options.limits.max_ref_length) {
+					throw syntax_error("too long character reference encountered");
+				}
+				this->ref_char_buf.push_back(*i);
+				break;
+		}
+	}
+}
+
+void parser_base::parse_attribute_seek_to_value(utki::span<const char>::iterator& i, utki::span<const char>::iterator& e)
+{
+	i = skip_whitespace(i, e);
+	if (i == e) {
+		return;
+	}
+
+	switch (*i) {
+		case '\'':
+		case '"':
+			this->attr_value_quote_char = *i;
+			this->cur_state = state::attribute_value;
+			return;
+		default:
+			throw syntax_error(R"(unexpected character encountered, expected "'" or '"'.)");
+	}
+}
+
+void parser_base::parse_attribute_seek_to_equals(utki::span<const char>::iterator& i, utki::span<const char>::iterator& e)
+{
+	i = skip_whitespace(i, e);
+	if (i == e) {
+		return;
+	}
+
+	if (*i != '=') {
+		std::stringstream ss;
+		ss << "unexpected character encountered (0x" << std::hex << unsigned(*i) << "), expected '='";
+		throw syntax_error(ss.str());
+	}
+
+	ASSERT(!this->attribute_name().empty())
+	ASSERT(this->buf.empty())
+	this->cur_state = state::attribute_seek_to_value;
+}
+
+void parser_base::process_parsed_attribute_name(
+	utki::span<const char>::iterator begin,
+	utki::span<const char>::iterator end
+)
+{
+	if (this->options.zero_copy && this->name.empty()) {
+		// the whole name is within the input data
+		this->attr_name_view = utki::make_span(&*begin, size_t(std::distance(begin, end)));
+	} else {
+		this->name.insert(std::end(this->name), begin, end);
+	}
+}
+
+void parser_base::parse_attribute_name(utki::span<const char>::iterator& i, utki::span<const char>::iterator& e)
+{
+	// start of the not yet buffered part of the name
+	auto name_begin = i;
+	for (; i != e; ++i) {
+		skip_to_class(i, e, char_class::attribute_name_end);
+		if (i == e) {
+			break;
+		}
+
+		switch (*i) {
+			case '\n':
+			case ' ':
+			case '\t':
+			case '\r':
+				this->process_parsed_attribute_name(name_begin, i);
+				ASSERT(!this->attribute_name().empty())
+				this->cur_state = state::attribute_seek_to_equals;
+				return;
+			case '=':
+				ASSERT(this->buf.empty())
+				this->process_parsed_attribute_name(name_begin, i);
+				this->cur_state = state::attribute_seek_to_value;
+				return;
+			default:
+				break;
+		}
+	}
+	this->name.insert(std::end(this->name), name_begin, e);
+}
+
+void parser_base::parse_comment(utki::span<const char>::iterator& i, utki::span<const char>::iterator& e)
+{
+	// the dashes are checked within the chunk, the states are only changed
+	// when the comment ends or when the chunk ends in the middle of the "-->"
+	for (;;) {
+		skip_to(i, e, '-');
+		if (i == e) {
+			return;
+		}
+
+		// the character after '-' is consumed in any case
+		auto dash = i;
+		++i;
+		if (i == e) {
+			i = dash;
+			this->cur_state = state::comment_end;
+			return;
+		}
+		if (*i != '-') {
+			++i;
+			continue;
+		}
+
+		// "--" not followed by '>' does not end the comment, the character after it is consumed
+		dash = i;
+		++i;
+		if (i == e) {
+			i = dash;
+			this->cur_state = state::comment_terminator;
+			return;
+		}
+		if (*i == '>') {
+			this->cur_state = state::idle;
+			return;
+		}
+		++i;
+	}
+}
+
+void parser_base::parse_comment_end(utki::span<const char>::iterator& i, utki::span<const char>::iterator& e)
+{
+	if (i == e) {
+		return;
+	}
+
+	// the character after '-' is consumed in any case
+	this->cur_state = *i == '-' ? state::comment_terminator : state::comment;
+}
+
+void parser_base::parse_comment_terminator(
+	utki::span<const char>::iterator& i, //
+	utki::span<const char>::iterator& e
+)
+{
+	if (i == e) {
+		return;
+	}
+
+	// "--" not followed by '>' does not end the comment, the character after it is consumed
+	this->cur_state = *i == '>' ? state::idle : state::comment;
+}
+
+void parser_base::parse_doctype(utki::span<const char>::iterator& i, utki::span<const char>::iterator& e)
+{
+	skip_to_first_of(i, e, '>', '[', '[');
+	if (i == e) {
+		return;
+	}
+
+	if (*i == '>') {
+		ASSERT(this->buf.empty())
+		this->cur_state = state::idle;
+	} else {
+		this->cur_state = state::doctype_body;
+	}
+}
+
+void parser_base::parse_doctype_body(utki::span<const char>::iterator& i, utki::span<const char>::iterator& e)
+{
+	skip_to_first_of(i, e, ']', '<', '<');
+	if (i == e) {
+		return;
+	}
+
+	if (*i == ']') {
+		ASSERT(this->buf.empty())
+		this->cur_state = state::doctype;
+	} else {
+		this->cur_state = state::doctype_tag;
+	}
+}
+void parser_base::process_parsed_doctype_tag_name(utki::span<const char> tag_name)
+{
+	if (tag_name.size() == 0) {
+		throw syntax_error("empty DOCTYPE tag name encountered");
+	}
+
+	if (starts_with(tag_name, doctype_element_tag_word) || starts_with(tag_name, doctype_attlist_tag_word)) {
+		this->cur_state = state::doctype_skip_tag;
+	} else if (starts_with(tag_name, doctype_entity_tag_word)) {
+		this->cur_state = state::doctype_entity_name;
+	} else {
+		throw syntax_error("unknown DOCTYPE tag encountered");
+	}
+}
+
+void parser_base::parse_doctype_tag(utki::span<const char>::iterator& i, utki::span<const char>::iterator& e)
+{
+	for (; i != e; ++i) {
+		switch (*i) {
+			case '\n':
+			case ' ':
+			case '\t':
+			case '\r':
+				this->process_parsed_doctype_tag_name(utki::make_span(this->buf.data(), this->buf.size()));
+				this->buf.clear();
+				return;
+			case '>':
+				throw syntax_error("unexpected > character while parsing DOCTYPE tag");
+			default:
+				this->buf.push_back(*i);
+				break;
+		}
+	}
+}
+
+void parser_base::parse_doctype_skip_tag(utki::span<const char>::iterator& i, utki::span<const char>::iterator& e)
+{
+	skip_to(i, e, '>');
+	if (i != e) {
+		ASSERT(this->buf.empty())
+		this->cur_state = state::doctype_body;
+	}
+}
+
+void parser_base::parse_doctype_entity_name(utki::span<const char>::iterator& i, utki::span<const char>::iterator& e)
+{
+	for (; i != e; ++i) {
+		switch (*i) {
+			case '\n':
+			case ' ':
+			case '\t':
+			case '\r':
+				if (this->buf.size() == 0) {
+					break;
+				}
+
+				this->name = std::move(this->buf);
+				ASSERT(this->buf.empty())
+
+				this->cur_state = state::doctype_entity_seek_to_value;
+				return;
+			default:
+				this->buf.push_back(*i);
+				break;
+		}
+	}
+}
+
+void parser_base::parse_doctype_entity_seek_to_value(
+	utki::span<const char>::iterator& i,
+	utki::span<const char>::iterator& e
+)
+{
+	for (; i != e; ++i) {
+		switch (*i) {
+			case '\n':
+			case ' ':
+			case '\t':
+			case '\r':
+				break;
+			case '"':
+				this->cur_state = state::doctype_entity_value;
+				return;
+			default:
+				throw syntax_error(
+					"unexpected character encountered while seeking to "
+					"DOCTYPE entity value, expected '\"'."
+				);
+		}
+	}
+}
+
+void parser_base::parse_doctype_entity_value(utki::span<const char>::iterator& i, utki::span<const char>::iterator& e)
+{
+	auto value_begin = i;
+	skip_to(i, e, '"');
+	this->buf.insert(std::end(this->buf), value_begin, i);
+	if (i == e) {
+		return;
+	}
+
+	this->add_doctype_entity(utki::make_span(this->name.data(), this->name.size()), std::move(this->buf));
+
+	this->name.clear();
+
+	ASSERT(this->buf.empty())
+
+	this->cur_state = state::doctype_skip_tag;
+}
+
+void parser_base::parse_skip_unknown_exclamation_mark_construct(
+	utki::span<const char>::iterator& i,
+	utki::span<const char>::iterator& e
+)
+{
+	skip_to(i, e, '>');
+	if (i != e) {
+		ASSERT(this->buf.empty())
+		this->cur_state = state::idle;
+	}
+}
+
+void parser_base::parse_tag_seek_gt(utki::span<const char>::iterator& i, utki::span<const char>::iterator& e)
+{
+	i = skip_whitespace(i, e);
+	if (i == e) {
+		return;
+	}
+
+	if (*i != '>') {
+		std::stringstream ss;
+		ss << "unexpected character encountered (" << *i << "), expected '>'.";
+		throw syntax_error(ss.str());
+	}
+
+	this->cur_state = state::idle;
+}
+
+void parser_base::parse_declaration(utki::span<const char>::iterator& i, utki::span<const char>::iterator& e)
+{
+	skip_to(i, e, '?');
+	if (i != e) {
+		this->cur_state = state::declaration_end;
+	}
+}
+
+void parser_base::parse_declaration_end(
+	utki::span<const char>::iterator& i, //
+	utki::span<const char>::iterator& e
+)
+{
+	if (i == e) {
+		return;
+	}
+
+	switch (*i) {
+		case '>':
+			this->cur_state = state::idle;
+			return;
+		default:
+			this->cur_state = state::declaration;
+			return;
+	}
+}
+
+void parser_base::parse_cdata(utki::span<const char>::iterator& i, utki::span<const char>::iterator& e)
+{
+	for (; i != e; ++i) {
+		switch (*i) {
+			case ']':
+				this->buf.push_back(*i);
+				this->cur_state = state::cdata_terminator;
+				return;
+			default:
+				this->buf.push_back(*i);
+				break;
+		}
+	}
+}
+
+void parser_base::parse_document_ref_char(const char*& p, const char* end)
+{
+	const char* ref_begin = p;
+
+	// do not search for the terminating ';' further than the longest allowed reference
+	const char* search_end = end;
+	size_t max_length = this->options.limits.max_ref_length;
+	if (size_t(end - p) > max_length) {
+		// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+		search_end = p + max_length + 1;
+	}
+
+	p = find(p, search_end, ';');
+	if (p == search_end) {
+		if (size_t(p - ref_begin) > max_length) {
+			// the error is reported at the first character exceeding the limit, same as in feed() mode
+			// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+			--p;
+			throw syntax_error("too long character reference encountered");
+		}
+		return;
+	}
+	this->expand_ref_char(utki::make_span(ref_begin, size_t(p - ref_begin)));
+	// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+	++p;
+}
+
+void parser_base::parse_document_comment(const char*& p, const char* end)
+{
+	// Same as parse_comment(), parse_comment_end() and parse_comment_terminator(): the character
+	// after each '-' is consumed, and the comment ends only with "-->" which is not preceded by another '-'.
+	while (p != end) {
+		p = find(p, end, '-');
+		if (p == end) {
+			return;
+		}
+		// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+		++p;
+
+		for (unsigned num_dashes = 1; p != end;) {
+			char c = *p;
+			// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+			++p;
+			if (num_dashes == 2 && c == '>') {
+				return;
+			}
+			if (num_dashes == 2 || c != '-') {
+				break;
+			}
+			++num_dashes;
+		}
+	}
+}
+
+void parser_base::parse_document_declaration(const char*& p, const char* end)
+{
+	// Same as parse_declaration() and parse_declaration_end():
+	// the character after each '?' is consumed, the declaration ends with "?>".
+	while (p != end) {
+		p = find(p, end, '?');
+		if (p == end) {
+			return;
+		}
+		// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+		++p;
+		if (p == end) {
+			return;
+		}
+		char c = *p;
+		// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+		++p;
+		if (c == '>') {
+			return;
+		}
+	}
+}
+
+void parser_base::parse_document_doctype(const char*& p, const char* end)
+{
+	for (;;) {
+		// skip to the end of the DOCTYPE or to the start of its body
+		p = find_first_of(p, end, '>', '[', '[');
+		if (p == end) {
+			return;
+		}
+		char c = *p;
+		// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+		++p;
+		if (c == '>') {
+			return;
+		}
+
+		// DOCTYPE body
+		for (;;) {
+			p = find_first_of(p, end, ']', '<', '<');
+			if (p == end) {
+				return;
+			}
+			c = *p;
+			// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+			++p;
+			if (c == ']') {
+				break;
+			}
+			if (!this->parse_document_doctype_tag(p, end)) {
+				return;
+			}
+		}
+	}
+}
+
+bool parser_base::parse_document_doctype_tag(const char*& p, const char* end)
+{
+	const char* name_begin = p;
+	// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+	for (; p != end && !is_whitespace(*p); ++p) {
+		if (*p == '>') {
+			throw syntax_error("unexpected > character while parsing DOCTYPE tag");
+		}
+	}
+	auto tag_name = utki::make_span(name_begin, size_t(p - name_begin));
+
+	// end of the document terminates the tag name same way as a whitespace
+	this->process_parsed_doctype_tag_name(tag_name);
+
+	if (p != end) {
+		// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+		++p;
+	}
+
+	if (this->cur_state == state::doctype_entity_name) {
+		if (!this->parse_document_doctype_entity(p, end)) {
+			return false;
+		}
+	}
+
+	p = find(p, end, '>');
+	if (p == end) {
+		return false;
+	}
+	// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+	++p;
+	return true;
+}
+
+bool parser_base::parse_document_doctype_entity(const char*& p, const char* end)
+{
+	p = skip_whitespace(p, end);
+
+	const char* name_begin = p;
+	skip_to_class(p, end, char_class::whitespace);
+	if (p == end) {
+		return false;
+	}
+	auto entity_name = utki::make_span(name_begin, size_t(p - name_begin));
+
+	p = skip_whitespace(p, end);
+	if (p == end) {
+		return false;
+	}
+	if (*p != '"') {
+		throw syntax_error(
+			"unexpected character encountered while seeking to "
+			"DOCTYPE entity value, expected '\"'."
+		);
+	}
+	// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+	++p;
+
+	const char* value_begin = p;
+	p = find(p, end, '"');
+	if (p == end) {
+		return false;
+	}
+
+	this->add_doctype_entity(entity_name, std::pmr::vector<char>(value_begin, p, this->buf.get_allocator()));
+
+	// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+	++p;
+	return true;
+}
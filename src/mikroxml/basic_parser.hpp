@@ -0,0 +1,1861 @@
+/*
+MIT License
+
+Copyright (c) 2017-2026 Ivan Gagis
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* ================ LICENSE END ================ */
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <memory_resource>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <utki/debug.hpp>
+#include <utki/span.hpp>
+
+#include "encoding.hpp"
+#include "name_table.hpp"
+#include "structural_index.hpp"
+
+namespace mikroxml {
+
+/**
+ * @brief Position in the input text.
+ */
+struct text_position {
+	/**
+	 * @brief Byte offset from the beginning of the input.
+	 */
+	size_t offset = 0;
+
+	/**
+	 * @brief Line number, starting from 1.
+	 */
+	unsigned line = 1;
+
+	/**
+	 * @brief Byte offset of the beginning of the line.
+	 */
+	size_t line_offset = 0;
+
+	/**
+	 * @brief Column number in bytes, starting from 1.
+	 */
+	size_t column() const noexcept
+	{
+		return this->offset - this->line_offset + 1;
+	}
+};
+
+class malformed_xml : public std::logic_error
+{
+	unsigned line_number;
+	size_t column_number = 0;
+	size_t byte_offset = 0;
+
+public:
+	malformed_xml(
+		unsigned line_number, //
+		const std::string& message
+	);
+
+	/**
+	 * @brief Construct exception pointing to the offending character.
+	 * @param position - position of the offending character in the input.
+	 * @param message - error description.
+	 */
+	malformed_xml(
+		const text_position& position, //
+		const std::string& message
+	);
+
+	/**
+	 * @brief Line of the error, starting from 1.
+	 */
+	unsigned line() const noexcept
+	{
+		return this->line_number;
+	}
+
+	/**
+	 * @brief Column of the error in bytes, starting from 1.
+	 * @return column number or 0 if unknown.
+	 */
+	size_t column() const noexcept
+	{
+		return this->column_number;
+	}
+
+	/**
+	 * @brief Byte offset of the error from the beginning of the input.
+	 * Valid only if column() is not 0.
+	 */
+	size_t offset() const noexcept
+	{
+		return this->byte_offset;
+	}
+};
+
+/**
+ * @brief Limits on the parsed input.
+ * The limits protect against malicious or broken input which would make the parser
+ * buffer unbounded amounts of data. Input exceeding any of the limits makes the parser
+ * throw malformed_xml. In feed() mode the limits on partially received tokens are checked
+ * at the end of each feed() call, so the amount of buffered data does not exceed the limit
+ * plus the size of the data chunk passed to feed().
+ * By default, everything is unlimited.
+ */
+struct parser_limits {
+	/**
+	 * @brief Maximal length of a text token in bytes.
+	 * Applies to content, CDATA blocks, attribute values and DOCTYPE entity values,
+	 * after character references expansion.
+	 */
+	size_t max_token_length = std::numeric_limits<size_t>::max();
+
+	/**
+	 * @brief Maximal length of element, attribute and DOCTYPE entity names in bytes.
+	 */
+	size_t max_name_length = std::numeric_limits<size_t>::max();
+
+	/**
+	 * @brief Maximal length of a character reference, not including the '&' and ';'.
+	 */
+	size_t max_ref_length = std::numeric_limits<size_t>::max();
+
+	/**
+	 * @brief Maximal nesting depth of elements.
+	 */
+	unsigned max_depth = std::numeric_limits<unsigned>::max();
+
+	/**
+	 * @brief Maximal number of DOCTYPE entities.
+	 */
+	size_t max_doctype_entities = std::numeric_limits<size_t>::max();
+
+	/**
+	 * @brief Maximal total number of bytes the DOCTYPE entity references expand to.
+	 */
+	size_t max_entity_expansion = std::numeric_limits<size_t>::max();
+
+	/**
+	 * @brief Split oversized content instead of failing.
+	 * If true, the content (including CDATA blocks) longer than max_token_length
+	 * is reported by several on_content_parsed() calls, each piece being at most
+	 * max_token_length bytes long, instead of throwing malformed_xml.
+	 * Multi-byte UTF-8 characters are not split between pieces, unless max_token_length
+	 * is less than the character length.
+	 * In feed() mode the pieces are reported as soon as enough content is received,
+	 * so that the content does not have to be buffered whole. For the content which is not
+	 * terminated by markup before the end of the document, the pieces followed by more content
+	 * are reported and the last piece is dropped, same in feed() mode and by parse_document().
+	 */
+	bool split_content = false;
+};
+
+/**
+ * @brief Parser options.
+ */
+struct parser_options {
+	/**
+	 * @brief Zero-copy mode.
+	 * In zero-copy mode, tokens (element names, attribute names and values, content)
+	 * which lie entirely within the data chunk passed to a single feed() call and
+	 * which do not need any transformation (character references expansion, '\r' removal)
+	 * are reported to callbacks as spans pointing directly into that data chunk.
+	 * Otherwise, tokens are copied to internal buffer before being reported.
+	 * In any case, the spans passed to callbacks are only valid during the callback call.
+	 */
+	bool zero_copy = false;
+
+	/**
+	 * @brief Content streaming mode.
+	 * In content streaming mode, the content (including CDATA blocks) is reported
+	 * by on_content_chunk() callback instead of on_content_parsed(). The part of the content
+	 * received by a single feed() call is reported before the feed() call returns,
+	 * so the content is never buffered whole. The last chunk of the content is reported
+	 * with is_last set to true, it can be empty.
+	 * parse_document() reports each content as a single last chunk.
+	 * The content which is not terminated by markup before the end of the document,
+	 * e.g. whitespace after the root element, is also reported and closed by the last chunk,
+	 * while without content streaming such content is not reported.
+	 * The parser_limits::max_token_length and parser_limits::split_content do not apply
+	 * to the streamed content.
+	 */
+	bool stream_content = false;
+
+	/**
+	 * @brief Table of known names.
+	 * If set, the element and attribute names are looked up in the table
+	 * before being reported, see parser_base::name_id().
+	 * The table must outlive the parser and must not be modified while it is used.
+	 */
+	const name_table* names = nullptr;
+
+	/**
+	 * @brief Input encoding detection.
+	 * If true, the encoding of the data passed to feed() and parse_document() is detected
+	 * from the byte order mark or the encoding declaration and the data is transcoded to UTF-8
+	 * right before parsing, see mikroxml::decoder. The byte order mark is not reported as content.
+	 * Otherwise, the data must be UTF-8, or the parsed tokens are reported in the input encoding.
+	 * Positions of malformed_xml errors are counted in the UTF-8 data.
+	 */
+	bool detect_encoding = false;
+
+	/**
+	 * @brief Memory resource for the parser's internal storage.
+	 * The token buffers, the DOCTYPE entities and the encoding decoder buffers are allocated
+	 * from this resource, e.g. a std::pmr::monotonic_buffer_resource per document avoids
+	 * contending for the global heap when parsing in many threads.
+	 * The buffers are kept by reset(), they are freed when the parser is destroyed.
+	 * If nullptr, the std::pmr::get_default_resource() at the parser construction time is used.
+	 * The resource must outlive the parser. A move-assigned parser keeps using its own resource,
+	 * i.e. its get_options().memory is not changed by the move assignment.
+	 * The resource is only used from the thread the parser is used in, see also parse_document_parallel().
+	 */
+	std::pmr::memory_resource* memory = nullptr;
+
+	/**
+	 * @brief Input limits.
+	 */
+	parser_limits limits;
+};
+
+/**
+ * @brief Whether the parser statistics are collected.
+ * The statistics are collected only if the MIKROXML_STATS macro is defined,
+ * otherwise the counting code is compiled out and parser_base::stats() stays zeroed.
+ * The macro has to be defined the same way when compiling the library and the code using it.
+ */
+#if defined(MIKROXML_STATS)
+constexpr bool stats_enabled = true;
+#else
+constexpr bool stats_enabled = false;
+#endif
+
+/**
+ * @brief Parser statistics.
+ * Collected only if stats_enabled is true, see parser_base::stats().
+ */
+struct parser_stats {
+	/**
+	 * @brief Number of bytes passed to feed() and parse_document().
+	 */
+	size_t bytes_fed = 0;
+
+	/**
+	 * @brief Number of feed() calls.
+	 */
+	size_t num_feed_calls = 0;
+
+	/**
+	 * @brief Number of parsed elements.
+	 */
+	size_t num_elements = 0;
+
+	/**
+	 * @brief Number of parsed attributes.
+	 */
+	size_t num_attributes = 0;
+
+	/**
+	 * @brief Number of parsed contents, including CDATA blocks.
+	 * Content reported in several pieces or chunks counts once.
+	 */
+	size_t num_contents = 0;
+
+	/**
+	 * @brief Number of expanded predefined entity references, like "&amp;".
+	 */
+	size_t num_named_refs = 0;
+
+	/**
+	 * @brief Number of expanded numeric character references, like "&#x20;".
+	 */
+	size_t num_numeric_refs = 0;
+
+	/**
+	 * @brief Number of expanded DOCTYPE entity references.
+	 */
+	size_t num_doctype_refs = 0;
+
+	/**
+	 * @brief Peak capacity of the token buffer in bytes.
+	 */
+	size_t peak_buf_capacity = 0;
+
+	/**
+	 * @brief Peak capacity of the name buffer in bytes.
+	 */
+	size_t peak_name_capacity = 0;
+
+	/**
+	 * @brief Peak capacity of the character reference buffer in bytes.
+	 */
+	size_t peak_ref_char_buf_capacity = 0;
+
+	constexpr static size_t num_states = 26;
+
+	/**
+	 * @brief Number of parsing steps done in each state of the parser.
+	 * Indexed by the state number, see state_name().
+	 * Only the feed() mode is counted, parse_document() does not go through the states.
+	 */
+	std::array<size_t, num_states> state_steps{};
+
+	/**
+	 * @brief Total time spent in feed(), end() and parse_document() calls.
+	 * The clock is read once at the beginning and once at the end of each call.
+	 */
+	std::chrono::nanoseconds parse_time{0};
+
+	/**
+	 * @brief Get name of the parser state.
+	 * @param state - state number, less than num_states.
+	 * @return The state name.
+	 */
+	static std::string_view state_name(size_t state) noexcept;
+};
+
+/**
+ * @brief Handler independent part of the parser.
+ * Holds the parser state and implements the parsing steps which do not
+ * report any events. Not intended to be used directly, see basic_parser.
+ */
+class parser_base
+{
+	template <typename>
+	friend class basic_parser;
+
+	friend class event_recorder;
+
+	// the pull parser uses the scanning helpers for skipping subtrees
+	friend class reader;
+
+	// the structural index uses the scanning helpers for the markup which is not scanned by blocks
+	friend class structural_index;
+
+	// the namespace errors are reported as syntax errors, so that they get the position
+	friend class namespace_resolver;
+
+	// syntax errors are thrown without position, the position is calculated
+	// from the input data when the exception leaves the parser
+	class syntax_error : public std::logic_error
+	{
+	public:
+		using std::logic_error::logic_error;
+	};
+
+	enum class state {
+		idle,
+		tag,
+		tag_seek_gt,
+		tag_empty,
+		declaration,
+		declaration_end,
+		comment,
+		comment_end,
+		comment_terminator,
+		attributes,
+		attribute_name,
+		attribute_seek_to_equals,
+		attribute_seek_to_value,
+		attribute_value,
+		content,
+		ref_char,
+		doctype,
+		doctype_body,
+		doctype_tag,
+		doctype_entity_name,
+		doctype_entity_seek_to_value,
+		doctype_entity_value,
+		doctype_skip_tag,
+		skip_unknown_exclamation_mark_construct,
+		cdata,
+		cdata_terminator
+	} cur_state = state::idle;
+
+	static_assert(size_t(state::cdata_terminator) + 1 == parser_stats::num_states);
+
+	static constexpr std::string_view comment_tag_word = "!--";
+	static constexpr std::string_view doctype_tag_word = "!DOCTYPE";
+	static constexpr std::string_view doctype_element_tag_word = "!ELEMENT";
+	static constexpr std::string_view doctype_attlist_tag_word = "!ATTLIST";
+	static constexpr std::string_view doctype_entity_tag_word = "!ENTITY";
+	static constexpr std::string_view cdata_tag_word = "![CDATA[";
+
+	// character classes, a character can belong to several classes,
+	// each class except whitespace contains all the whitespace characters,
+	// so that runs of ordinary characters never contain new lines
+	enum char_class : uint8_t {
+		whitespace = 1 << 0,
+
+		// characters interrupting tag name in feed() mode: whitespace, '>', '/', '[', '-'
+		tag_name_special = 1 << 1,
+
+		// characters terminating tag name in parse_document() mode: whitespace, '>', '/'
+		tag_name_end = 1 << 2,
+
+		// characters terminating attribute name: whitespace, '='
+		attribute_name_end = 1 << 3
+	};
+
+	static constexpr std::array<uint8_t, 256> make_char_classes() noexcept;
+
+	// the table is generated at compile time
+	static const std::array<uint8_t, 256> char_classes;
+
+	static bool is_of_class(char c, char_class cls) noexcept
+	{
+		return (char_classes[uint8_t(c)] & cls) != 0;
+	}
+
+	static bool is_whitespace(char c) noexcept
+	{
+		return is_of_class(c, char_class::whitespace);
+	}
+
+	// moves the iterator to the first character of the class, or to the end of the range
+	template <typename iterator_type>
+	static void skip_to_class(iterator_type& i, iterator_type e, char_class cls) noexcept
+	{
+		for (; i != e && !is_of_class(*i, cls); ++i) {
+		}
+	}
+
+	template <typename iterator_type>
+	static iterator_type skip_whitespace(iterator_type i, iterator_type e) noexcept
+	{
+		for (; i != e && is_whitespace(*i); ++i) {
+		}
+		return i;
+	}
+
+	static bool starts_with(utki::span<const char> span, std::string_view str) noexcept;
+	static bool starts_with(const char* p, const char* end, std::string_view str) noexcept;
+
+	static const char* find_first_of(
+		const char* p, //
+		const char* end,
+		char c1,
+		char c2,
+		char c3
+	) noexcept;
+
+	static const char* find(const char* p, const char* end, char c) noexcept;
+	static const char* find(const char* p, const char* end, std::string_view str) noexcept;
+
+	static void skip_to_first_of(
+		utki::span<const char>::iterator& i,
+		utki::span<const char>::iterator& e,
+		char c1,
+		char c2,
+		char c3
+	);
+
+	static void skip_to(utki::span<const char>::iterator& i, utki::span<const char>::iterator& e, char c);
+
+	// returns position of the 'end' given that 'begin' is at the 'position'
+	static text_position advance(text_position position, const char* begin, const char* end) noexcept;
+
+	void parse_attribute_name(utki::span<const char>::iterator& i, utki::span<const char>::iterator& e);
+	void parse_attribute_seek_to_equals(utki::span<const char>::iterator& i, utki::span<const char>::iterator& e);
+	void parse_attribute_seek_to_value(utki::span<const char>::iterator& i, utki::span<const char>::iterator& e);
+	void parse_comment(utki::span<const char>::iterator& i, utki::span<const char>::iterator& e);
+	void parse_comment_end(utki::span<const char>::iterator& i, utki::span<const char>::iterator& e);
+	void parse_comment_terminator(utki::span<const char>::iterator& i, utki::span<const char>::iterator& e);
+	void parse_declaration(utki::span<const char>::iterator& i, utki::span<const char>::iterator& e);
+	void parse_declaration_end(utki::span<const char>::iterator& i, utki::span<const char>::iterator& e);
+	void parse_ref_char(utki::span<const char>::iterator& i, utki::span<const char>::iterator& e);
+	void parse_doctype(utki::span<const char>::iterator& i, utki::span<const char>::iterator& e);
+	void parse_doctype_body(utki::span<const char>::iterator& i, utki::span<const char>::iterator& e);
+	void parse_doctype_tag(utki::span<const char>::iterator& i, utki::span<const char>::iterator& e);
+	void parse_doctype_skip_tag(utki::span<const char>::iterator& i, utki::span<const char>::iterator& e);
+	void parse_doctype_entity_name(utki::span<const char>::iterator& i, utki::span<const char>::iterator& e);
+	void parse_doctype_entity_seek_to_value(utki::span<const char>::iterator& i, utki::span<const char>::iterator& e);
+	void parse_doctype_entity_value(utki::span<const char>::iterator& i, utki::span<const char>::iterator& e);
+	void parse_skip_unknown_exclamation_mark_construct(
+		utki::span<const char>::iterator& i,
+		utki::span<const char>::iterator& e
+	);
+	void parse_tag_seek_gt(utki::span<const char>::iterator& i, utki::span<const char>::iterator& e);
+	void parse_cdata(utki::span<const char>::iterator& i, utki::span<const char>::iterator& e);
+
+	void parse_document_ref_char(const char*& p, const char* end);
+	void parse_document_comment(const char*& p, const char* end);
+	void parse_document_declaration(const char*& p, const char* end);
+	void parse_document_doctype(const char*& p, const char* end);
+	bool parse_document_doctype_tag(const char*& p, const char* end);
+	bool parse_document_doctype_entity(const char*& p, const char* end);
+
+	utki::span<const char> make_token(
+		std::pmr::vector<char>& buffer,
+		utki::span<const char>::iterator begin,
+		utki::span<const char>::iterator end
+	);
+
+	void process_parsed_attribute_name(utki::span<const char>::iterator begin, utki::span<const char>::iterator end);
+
+	utki::span<const char> attribute_name() const noexcept;
+
+	void release_input();
+
+	void process_parsed_ref_char();
+
+	void expand_ref_char(utki::span<const char> ref_char);
+
+	void process_parsed_doctype_tag_name(utki::span<const char> tag_name);
+
+	void add_doctype_entity(utki::span<const char> entity_name, std::pmr::vector<char> value);
+
+	void check_name_length(utki::span<const char> name) const;
+	void check_markup_name_length(utki::span<const char> tag_name) const;
+	void check_token_length(size_t length) const;
+	void check_buffered_size() const;
+
+	bool is_in_content() const noexcept;
+
+	void enter_element();
+	void leave_element() noexcept;
+
+	// returns length of the next content piece to report when splitting oversized content
+	static size_t content_piece_length(utki::span<const char> content, size_t max_length) noexcept;
+
+	std::pmr::vector<char> buf;
+
+	// general variable for storing name of something
+	// (attribute name, entity name, etc.)
+	std::pmr::vector<char> name;
+
+	std::pmr::vector<char> ref_char_buf;
+
+	// attribute name pointing directly into the input data in zero-copy mode
+	utki::span<const char> attr_name_view;
+
+	char attr_value_quote_char = 0;
+
+	state state_after_ref_char = state::idle;
+
+	// position of the beginning of the data passed to the current feed() call,
+	// line numbers are calculated from the input data only when needed
+	text_position chunk_position;
+
+	// number of currently open elements
+	unsigned depth = 0;
+
+	// total size of the expanded DOCTYPE entity references
+	size_t entity_expansion_size = 0;
+
+	class doctype_entity_table
+	{
+		// the deque does not relocate its elements when growing or when moved,
+		// so the names can be referred to by the keys of the values map
+		std::pmr::deque<std::pmr::string> names;
+
+		std::pmr::unordered_map<std::string_view, std::pmr::vector<char>> values;
+
+	public:
+		explicit doctype_entity_table(std::pmr::memory_resource* memory) :
+			names(memory),
+			values(memory)
+		{}
+
+		doctype_entity_table(const doctype_entity_table&) = delete;
+		doctype_entity_table& operator=(const doctype_entity_table&) = delete;
+
+		doctype_entity_table(doctype_entity_table&&) = default;
+
+		// the names are relocated if the tables use different memory resources,
+		// so the entities are added anew in that case
+		doctype_entity_table& operator=(doctype_entity_table&& other);
+
+		~doctype_entity_table() = default;
+
+		bool empty() const noexcept
+		{
+			return this->values.empty();
+		}
+
+		size_t size() const noexcept
+		{
+			return this->values.size();
+		}
+
+		// returns nullptr if there is no such entity
+		const std::pmr::vector<char>* find(std::string_view name) const;
+
+		// the entity must not be defined yet
+		void add(std::string_view name, std::pmr::vector<char> value);
+
+		void clear() noexcept;
+	};
+
+	doctype_entity_table doctype_entities;
+
+	parser_options options;
+
+	// transcodes the input to UTF-8 if encoding detection is enabled
+	decoder input_decoder;
+
+	// symbol id of the element or attribute name being reported
+	unsigned cur_name_id = name_table::unknown;
+
+	// stays zeroed unless stats_enabled
+	parser_stats collected_stats;
+
+	// adds its lifetime to the parse time statistics, does nothing unless stats_enabled
+	class parse_timer
+	{
+		parser_stats& stats;
+		std::chrono::steady_clock::time_point start;
+
+	public:
+		explicit parse_timer(parser_stats& stats) noexcept :
+			stats(stats)
+		{
+			if constexpr (stats_enabled) {
+				this->start = std::chrono::steady_clock::now();
+			}
+		}
+
+		parse_timer(const parse_timer&) = delete;
+		parse_timer& operator=(const parse_timer&) = delete;
+
+		parse_timer(parse_timer&&) = delete;
+		parse_timer& operator=(parse_timer&&) = delete;
+
+		~parse_timer()
+		{
+			if constexpr (stats_enabled) {
+				this->stats.parse_time += std::chrono::steady_clock::now() - this->start;
+			}
+		}
+	};
+
+	void update_peak_capacities() noexcept;
+
+	void lookup_name_id(utki::span<const char> name) noexcept
+	{
+		if (this->options.names) {
+			this->cur_name_id = this->options.names->find(std::string_view(name.data(), name.size()));
+		}
+	}
+
+	explicit parser_base(const parser_options& options);
+
+public:
+	/**
+	 * @brief Get parser options.
+	 * @return The options the parser was constructed with.
+	 */
+	const parser_options& get_options() const noexcept
+	{
+		return this->options;
+	}
+
+	/**
+	 * @brief Get symbol id of the reported name.
+	 * Can be called from within on_element_start(), on_element_end() and
+	 * on_attribute_parsed() callbacks to get the id of the reported element
+	 * or attribute name in the name table set in parser options.
+	 * @return The name id, or name_table::unknown if the name is not in the table,
+	 *         or if there is no name table set, or if empty element has ended.
+	 */
+	unsigned name_id() const noexcept
+	{
+		return this->cur_name_id;
+	}
+
+	/**
+	 * @brief Get the input encoding.
+	 * @return The detected encoding of the input, or encoding::unknown if it is not detected yet
+	 *         or if parser_options::detect_encoding is not set.
+	 */
+	encoding input_encoding() const noexcept
+	{
+		return this->input_decoder.get_encoding();
+	}
+
+	/**
+	 * @brief Get parser statistics.
+	 * The statistics are accumulated over all the parsed data until reset().
+	 * @return The statistics, all zeros if stats_enabled is false.
+	 */
+	const parser_stats& stats() const noexcept
+	{
+		return this->collected_stats;
+	}
+
+	/**
+	 * @brief Reset parser to its initial state.
+	 * Drops any partially parsed data, the declared DOCTYPE entities and the statistics,
+	 * so that the parser can be reused for parsing another document.
+	 * The memory allocated for the internal buffers is kept.
+	 * The options are not changed.
+	 */
+	void reset() noexcept;
+
+	parser_base(const parser_base&) = delete;
+	parser_base& operator=(const parser_base&) = delete;
+
+	// the DOCTYPE entity table keeps its keys valid when moved
+	parser_base(parser_base&&) = default;
+
+	// the internal storage stays allocated from the memory resource of this parser,
+	// so the parser_options::memory of this parser is kept, the other options are taken over
+	parser_base& operator=(parser_base&& other);
+
+	~parser_base() = default;
+};
+
+/**
+ * @brief XML parser with compile-time dispatch of events.
+ * The events are reported by calling the handler's methods directly,
+ * without virtual calls, so that the handler can be inlined into the parsing loop.
+ * The handler_type must derive from basic_parser<handler_type> (CRTP) and
+ * provide the following methods, accessible from basic_parser:
+ * @code
+ * void on_element_start(utki::span<const char> name);
+ * void on_element_end(utki::span<const char> name);
+ * void on_attributes_end(bool is_empty_element);
+ * void on_attribute_parsed(utki::span<const char> name, utki::span<const char> value);
+ * void on_content_parsed(utki::span<const char> str);
+ * @endcode
+ * See mikroxml::parser for description of each event.
+ * @tparam handler_type - the derived class handling the events.
+ */
+template <typename handler_type>
+class basic_parser : public parser_base
+{
+	handler_type& handler() noexcept
+	{
+		return static_cast<handler_type&>(*this);
+	}
+
+	void feed_utf8(utki::span<const char> data);
+
+	// parses the data passed to feed(), on syntax error the 'i' points to the offending character
+	void parse_chunk(utki::span<const char>::iterator& i, utki::span<const char>::iterator& e);
+
+	// calls the parsing step of the current state
+	void parse_state(utki::span<const char>::iterator& i, utki::span<const char>::iterator& e);
+
+	void parse_idle(utki::span<const char>::iterator& i, utki::span<const char>::iterator& e);
+	void parse_tag(utki::span<const char>::iterator& i, utki::span<const char>::iterator& e);
+	void parse_tag_empty(utki::span<const char>::iterator& i, utki::span<const char>::iterator& e);
+	void parse_attributes(utki::span<const char>::iterator& i, utki::span<const char>::iterator& e);
+	void parse_attribute_value(utki::span<const char>::iterator& i, utki::span<const char>::iterator& e);
+	void parse_content(utki::span<const char>::iterator& i, utki::span<const char>::iterator& e);
+	void parse_cdata_terminator(utki::span<const char>::iterator& i, utki::span<const char>::iterator& e);
+
+	void parse_document_range(const char*& p, const char* end);
+	void parse_document_content(const char*& p, const char* end);
+	void parse_document_markup(const char*& p, const char* end);
+	void parse_document_tag_empty(const char*& p, const char* end);
+	void parse_document_attributes(const char*& p, const char* end);
+	bool parse_document_attribute(const char*& p, const char* end);
+	void parse_document_cdata(const char*& p, const char* end);
+
+	void handle_attribute_parsed(utki::span<const char> value);
+
+	void report_content(utki::span<const char> content);
+
+	// reports the pieces of the content while it is longer than max_token_length, returns the rest
+	utki::span<const char> report_full_content_pieces(utki::span<const char> content);
+
+	void report_buffered_content_pieces();
+
+	void report_buffered_content_chunk();
+
+	void report_unterminated_content(utki::span<const char> content);
+
+	void process_parsed_tag_name(utki::span<const char> tag_name);
+
+protected:
+	explicit basic_parser(const parser_options& options = {}) :
+		parser_base(options)
+	{}
+
+	/**
+	 * @brief Content chunk parsed notification.
+	 * Called instead of on_content_parsed() in content streaming mode, see parser_options::stream_content.
+	 * The handler_type can provide its own on_content_chunk() method, by default
+	 * each non-empty chunk is reported by on_content_parsed().
+	 * @param chunk - next part of the content.
+	 * @param is_last - true if the content has ended.
+	 */
+	void on_content_chunk(utki::span<const char> chunk, bool is_last)
+	{
+		if (!chunk.empty()) {
+			this->handler().on_content_parsed(chunk);
+		}
+	}
+
+public:
+	/**
+	 * @brief feed UTF-8 data to parser.
+	 * The data can be in other encoding if parser_options::detect_encoding is set.
+	 * Position of the malformed_xml error is counted from the beginning of all the fed data.
+	 * @param data - data to be fed to parser.
+	 * @throw std::invalid_argument - if encoding detection is enabled and the declared encoding is not supported.
+	 */
+	void feed(utki::span<const char> data);
+
+	/**
+	 * @brief feed UTF-8 data to parser.
+	 * @param data - data to be fed to parser.
+	 */
+	void feed(utki::span<const uint8_t> data)
+	{
+		this->feed(to_char(data));
+	}
+
+	/**
+	 * @brief Parse in string.
+	 * @param str - string to parse.
+	 */
+	void feed(const std::string& str)
+	{
+		this->feed(utki::make_span(str.c_str(), str.length()));
+	}
+
+	/**
+	 * @brief Finalize parsing after all data has been fed.
+	 * The content which is not terminated by markup is not reported,
+	 * same as by parse_document(), see also parser_options::stream_content.
+	 */
+	void end();
+
+	/**
+	 * @brief Parse whole UTF-8 document.
+	 * Parses the complete document in one go, e.g. a memory-mapped file.
+	 * Since the whole document is known to be available, the parsing is done
+	 * without maintaining resumable state between tokens, which is faster than feed().
+	 * The reported events are the same as if the document was passed to feed() followed by end().
+	 * Tokens which do not need any transformation are reported as spans pointing directly
+	 * into the document, regardless of the parser_options::zero_copy setting.
+	 * The parser must not be in the middle of parsing data passed to feed().
+	 * Position of the malformed_xml error is relative to the beginning of the document.
+	 * If parser_options::detect_encoding is set, the document in other than UTF-8 encoding
+	 * is transcoded as a whole before parsing, the tokens then point into the transcoded copy.
+	 * @param document - the complete document to parse.
+	 */
+	void parse_document(utki::span<const char> document);
+
+	/**
+	 * @brief Parse whole UTF-8 document using its structural index.
+	 * Same as parse_document(utki::span<const char>), but the content between markup
+	 * is not scanned, its bounds are taken from the index. The index can be reused
+	 * for parsing the same document several times, e.g. with different handlers.
+	 * If a markup turns out to end at a different position than the index says,
+	 * which is only possible in a malformed document, the rest of the document
+	 * is parsed without the index.
+	 * The indexed document must be UTF-8, the parser_options::detect_encoding does not apply.
+	 * @param index - structural index of the complete document to parse.
+	 */
+	void parse_document(const structural_index& index);
+};
+
+template <typename handler_type>
+void basic_parser<handler_type>::feed(utki::span<const char> data)
+{
+	parse_timer timer(this->collected_stats);
+
+	if constexpr (stats_enabled) {
+		this->collected_stats.bytes_fed += data.size();
+		++this->collected_stats.num_feed_calls;
+	}
+
+	if (this->options.detect_encoding) {
+		this->feed_utf8(this->input_decoder.decode(data));
+	} else {
+		this->feed_utf8(data);
+	}
+}
+
+template <typename handler_type>
+void basic_parser<handler_type>::feed_utf8(utki::span<const char> data)
+{
+	auto i = data.begin();
+	auto e = data.end();
+	try {
+		this->parse_chunk(i, e);
+	} catch (syntax_error& error) {
+		// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+		const char* p = data.data() + std::distance(data.begin(), i);
+		throw malformed_xml(advance(this->chunk_position, data.data(), p), error.what());
+	}
+
+	// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+	this->chunk_position = advance(this->chunk_position, data.data(), data.data() + data.size());
+
+	this->update_peak_capacities();
+}
+
+template <typename handler_type>
+void basic_parser<handler_type>::parse_chunk(utki::span<const char>::iterator& i, utki::span<const char>::iterator& e)
+{
+	for (; i != e; ++i) {
+		if constexpr (stats_enabled) {
+			++this->collected_stats.state_steps[size_t(this->cur_state)];
+		}
+		this->parse_state(i, e);
+		if (i == e) {
+			break;
+		}
+	}
+
+	if (this->options.stream_content) {
+		this->report_buffered_content_chunk();
+	} else if (this->options.limits.split_content) {
+		this->report_buffered_content_pieces();
+	}
+
+	this->release_input();
+
+	this->check_buffered_size();
+}
+
+template <typename handler_type>
+void basic_parser<handler_type>::parse_state(utki::span<const char>::iterator& i, utki::span<const char>::iterator& e)
+{
+	switch (this->cur_state) {
+		case state::idle:
+			this->parse_idle(i, e);
+			break;
+		case state::tag:
+			this->parse_tag(i, e);
+			break;
+		case state::tag_empty:
+			this->parse_tag_empty(i, e);
+			break;
+		case state::tag_seek_gt:
+			this->parse_tag_seek_gt(i, e);
+			break;
+		case state::declaration:
+			this->parse_declaration(i, e);
+			break;
+		case state::declaration_end:
+			this->parse_declaration_end(i, e);
+			break;
+		case state::comment:
+			this->parse_comment(i, e);
+			break;
+		case state::comment_end:
+			this->parse_comment_end(i, e);
+			break;
+		case state::comment_terminator:
+			this->parse_comment_terminator(i, e);
+			break;
+		case state::attributes:
+			this->parse_attributes(i, e);
+			break;
+		case state::attribute_name:
+			this->parse_attribute_name(i, e);
+			break;
+		case state::attribute_seek_to_equals:
+			this->parse_attribute_seek_to_equals(i, e);
+			break;
+		case state::attribute_seek_to_value:
+			this->parse_attribute_seek_to_value(i, e);
+			break;
+		case state::attribute_value:
+			this->parse_attribute_value(i, e);
+			break;
+		case state::content:
+			this->parse_content(i, e);
+			break;
+		case state::ref_char:
+			this->parse_ref_char(i, e);
+			break;
+		case state::doctype:
+			this->parse_doctype(i, e);
+			break;
+		case state::doctype_body:
+			this->parse_doctype_body(i, e);
+			break;
+		case state::doctype_tag:
+			this->parse_doctype_tag(i, e);
+			break;
+		case state::doctype_skip_tag:
+			this->parse_doctype_skip_tag(i, e);
+			break;
+		case state::doctype_entity_name:
+			this->parse_doctype_entity_name(i, e);
+			break;
+		case state::doctype_entity_seek_to_value:
+			this->parse_doctype_entity_seek_to_value(i, e);
+			break;
+		case state::doctype_entity_value:
+			this->parse_doctype_entity_value(i, e);
+			break;
+		case state::skip_unknown_exclamation_mark_construct:
+			this->parse_skip_unknown_exclamation_mark_construct(i, e);
+			break;
+		case state::cdata:
+			this->parse_cdata(i, e);
+			break;
+		case state::cdata_terminator:
+			this->parse_cdata_terminator(i, e);
+			break;
+	}
+}
+
+template <typename handler_type>
+void basic_parser<handler_type>::parse_tag_empty(utki::span<const char>::iterator& i, utki::span<const char>::iterator& e)
+{
+	utki::assert(this->buf.empty(), SL);
+	utki::assert(this->name.empty(), SL);
+
+	if (i == e) {
+		return;
+	}
+
+	switch (*i) {
+		case '>':
+			this->handler().on_attributes_end(true);
+			this->leave_element();
+			this->cur_name_id = name_table::unknown;
+			this->handler().on_element_end(utki::make_span<char>(nullptr, 0));
+			this->cur_state = state::idle;
+			return;
+		default:
+			throw syntax_error("unexpected '/' character in attribute list encountered.");
+	}
+}
+
+template <typename handler_type>
+void basic_parser<handler_type>::parse_content(utki::span<const char>::iterator& i, utki::span<const char>::iterator& e)
+{
+	for (; i != e; ++i) {
+		auto run_begin = i;
+		skip_to_first_of(i, e, '<', '&', '\r');
+		if (i == e) {
+			if (this->options.stream_content) {
+				this->handler().on_content_chunk(this->make_token(this->buf, run_begin, e), false);
+				this->buf.clear();
+			} else {
+				this->buf.insert(std::end(this->buf), run_begin, e);
+			}
+			return;
+		}
+
+		switch (*i) {
+			case '<':
+				this->report_content(this->make_token(this->buf, run_begin, i));
+				this->buf.clear();
+				this->cur_state = state::tag;
+				return;
+			case '&':
+				ASSERT(this->ref_char_buf.empty())
+				this->buf.insert(std::end(this->buf), run_begin, i);
+				this->state_after_ref_char = this->cur_state;
+				this->cur_state = state::ref_char;
+				return;
+			default:
+				ASSERT(*i == '\r')
+				// ignore
+				this->buf.insert(std::end(this->buf), run_begin, i);
+				break;
+		}
+	}
+}
+
+template <typename handler_type>
+void basic_parser<handler_type>::handle_attribute_parsed(utki::span<const char> value)
+{
+	auto attr_name = this->attribute_name();
+	this->check_name_length(attr_name);
+	this->check_token_length(value.size());
+	this->lookup_name_id(attr_name);
+	if constexpr (stats_enabled) {
+		++this->collected_stats.num_attributes;
+	}
+	this->handler().on_attribute_parsed(attr_name, value);
+	this->attr_name_view = {};
+	this->name.clear();
+	this->buf.clear();
+	this->cur_state = state::attributes;
+}
+
+template <typename handler_type>
+void basic_parser<handler_type>::report_content(utki::span<const char> content)
+{
+	if constexpr (stats_enabled) {
+		++this->collected_stats.num_contents;
+	}
+
+	if (this->options.stream_content) {
+		this->handler().on_content_chunk(content, true);
+		return;
+	}
+
+	size_t max_length = this->options.limits.max_token_length;
+	if (content.size() <= max_length) {
+		this->handler().on_content_parsed(content);
+		return;
+	}
+
+	if (!this->options.limits.split_content) {
+		throw syntax_error("too long content encountered");
+	}
+
+	while (!content.empty()) {
+		auto length = content_piece_length(content, max_length);
+		this->handler().on_content_parsed(content.subspan(0, length));
+		content = content.subspan(length);
+	}
+}
+
+template <typename handler_type>
+utki::span<const char> basic_parser<handler_type>::report_full_content_pieces(utki::span<const char> content)
+{
+	size_t max_length = this->options.limits.max_token_length;
+	while (content.size() > max_length) {
+		auto length = content_piece_length(content, max_length);
+		this->handler().on_content_parsed(content.subspan(0, length));
+		content = content.subspan(length);
+	}
+	return content;
+}
+
+template <typename handler_type>
+void basic_parser<handler_type>::report_buffered_content_pieces()
+{
+	if (!this->is_in_content()) {
+		return;
+	}
+
+	// report full pieces, keep the rest buffered until more content is received
+	auto content = this->report_full_content_pieces(utki::make_span(this->buf.data(), this->buf.size()));
+
+	this->buf.erase(
+		std::begin(this->buf), //
+		std::next(std::begin(this->buf), std::ptrdiff_t(this->buf.size() - content.size()))
+	);
+}
+
+template <typename handler_type>
+void basic_parser<handler_type>::report_buffered_content_chunk()
+{
+	if (this->buf.empty() || !this->is_in_content()) {
+		return;
+	}
+	this->handler().on_content_chunk(utki::make_span(this->buf.data(), this->buf.size()), false);
+	this->buf.clear();
+}
+
+template <typename handler_type>
+void basic_parser<handler_type>::report_unterminated_content(utki::span<const char> content)
+{
+	// the unterminated content is not reported, but in streaming mode the chunks
+	// of the content can already be reported, so the content has to be closed
+	if (this->options.stream_content) {
+		if constexpr (stats_enabled) {
+			++this->collected_stats.num_contents;
+		}
+		this->handler().on_content_chunk(content, true);
+	} else if (this->options.limits.split_content) {
+		// in feed() mode the full pieces are reported as soon as they are received,
+		// the last piece is dropped since it is not known to be complete
+		this->report_full_content_pieces(content);
+	}
+}
+
+template <typename handler_type>
+void basic_parser<handler_type>::parse_attribute_value(utki::span<const char>::iterator& i, utki::span<const char>::iterator& e)
+{
+	ASSERT(!this->attribute_name().empty())
+	for (; i != e; ++i) {
+		auto run_begin = i;
+		skip_to_first_of(i, e, this->attr_value_quote_char, '&', '\r');
+		if (i == e) {
+			this->buf.insert(std::end(this->buf), run_begin, e);
+			return;
+		}
+
+		switch (*i) {
+			case '&':
+				ASSERT(this->ref_char_buf.empty())
+				this->buf.insert(std::end(this->buf), run_begin, i);
+				this->state_after_ref_char = this->cur_state;
+				this->cur_state = state::ref_char;
+				return;
+			case '\r':
+				// ignore
+				this->buf.insert(std::end(this->buf), run_begin, i);
+				break;
+			default:
+				ASSERT(*i == this->attr_value_quote_char)
+				this->handle_attribute_parsed(this->make_token(this->buf, run_begin, i));
+				return;
+		}
+	}
+}
+
+template <typename handler_type>
+void basic_parser<handler_type>::parse_attributes(utki::span<const char>::iterator& i, utki::span<const char>::iterator& e)
+{
+	ASSERT(this->buf.empty())
+	ASSERT(this->name.empty())
+
+	i = skip_whitespace(i, e);
+	if (i == e) {
+		return;
+	}
+
+	switch (*i) {
+		case '/':
+			this->cur_state = state::tag_empty;
+			return;
+		case '>':
+			this->handler().on_attributes_end(false);
+			this->cur_state = state::idle;
+			return;
+		case '=':
+			throw syntax_error("unexpected '=' encountered");
+		default:
+			this->cur_state = state::attribute_name;
+			this->parse_attribute_name(i, e);
+			return;
+	}
+}
+
+template <typename handler_type>
+void basic_parser<handler_type>::end()
+{
+	parse_timer timer(this->collected_stats);
+
+	if (this->options.detect_encoding) {
+		// the beginning of a short input can still be buffered for the encoding detection
+		this->feed_utf8(this->input_decoder.decode(utki::span<const char>(), true));
+	}
+
+	if (this->is_in_content() || this->cur_state == state::cdata_terminator) {
+		// the end of data does not terminate the content, the buffered content is not a part of any token
+		this->report_unterminated_content(utki::make_span(this->buf.data(), this->buf.size()));
+		this->buf.clear();
+		this->ref_char_buf.clear();
+		this->cur_state = state::idle;
+	} else if (this->cur_state != state::idle) {
+		// the end of data terminates the last token same way as a new line character,
+		// the new line is not a part of the input, so errors are reported at the end of data
+		const std::array<char, 1> new_line = {{'\n'}};
+		auto span = utki::make_span(new_line);
+		auto i = span.begin();
+		auto e = span.end();
+		try {
+			this->parse_chunk(i, e);
+		} catch (syntax_error& error) {
+			throw malformed_xml(this->chunk_position, error.what());
+		}
+	}
+
+	this->update_peak_capacities();
+}
+
+template <typename handler_type>
+void basic_parser<handler_type>::process_parsed_tag_name(utki::span<const char> tag_name)
+{
+	if (tag_name.empty()) {
+		throw syntax_error("tag name cannot be empty");
+	}
+
+	switch (tag_name[0]) {
+		case '?':
+			// some declaration, we just skip it.
+			this->check_markup_name_length(tag_name);
+			this->buf.clear();
+			this->cur_state = state::declaration;
+			return;
+		case '!':
+			this->check_markup_name_length(tag_name);
+			if (starts_with(tag_name, doctype_tag_word)) {
+				this->cur_state = state::doctype;
+			} else {
+				this->cur_state = state::skip_unknown_exclamation_mark_construct;
+			}
+			this->buf.clear();
+			return;
+		case '/':
+			if (tag_name.size() <= 1) {
+				throw syntax_error("end tag cannot be empty");
+			}
+			this->check_name_length(tag_name.subspan(1));
+			this->leave_element();
+			this->lookup_name_id(tag_name.subspan(1));
+			this->handler().on_element_end(tag_name.subspan(1));
+			this->buf.clear();
+			this->cur_state = state::tag_seek_gt;
+			return;
+		default:
+			this->check_name_length(tag_name);
+			this->enter_element();
+			this->lookup_name_id(tag_name);
+			this->handler().on_element_start(tag_name);
+			this->buf.clear();
+			this->cur_state = state::attributes;
+			return;
+	}
+}
+
+template <typename handler_type>
+void basic_parser<handler_type>::parse_tag(utki::span<const char>::iterator& i, utki::span<const char>::iterator& e)
+{
+	// start of the not yet buffered part of the tag name
+	auto name_begin = i;
+	for (; i != e; ++i) {
+		skip_to_class(i, e, char_class::tag_name_special);
+		if (i == e) {
+			break;
+		}
+
+		switch (*i) {
+			case '\n':
+			case ' ':
+			case '\t':
+			case '\r':
+				this->process_parsed_tag_name(this->make_token(this->buf, name_begin, i));
+				return;
+			case '>':
+				this->process_parsed_tag_name(this->make_token(this->buf, name_begin, i));
+				switch (this->cur_state) {
+					case state::attributes:
+						this->handler().on_attributes_end(false);
+						[[fallthrough]];
+					default:
+						this->cur_state = state::idle;
+						break;
+				}
+				return;
+			case '[':
+				this->buf.insert(std::end(this->buf), name_begin, std::next(i));
+				name_begin = std::next(i);
+				if (this->buf.size() == cdata_tag_word.size() && starts_with(this->buf, cdata_tag_word)) {
+					this->buf.clear();
+					this->cur_state = state::cdata;
+					return;
+				}
+				break;
+			case '-':
+				this->buf.insert(std::end(this->buf), name_begin, std::next(i));
+				name_begin = std::next(i);
+				if (this->buf.size() == comment_tag_word.size() && starts_with(this->buf, comment_tag_word)) {
+					this->cur_state = state::comment;
+					this->buf.clear();
+					return;
+				}
+				break;
+			case '/':
+				if (!this->buf.empty() || name_begin != i) {
+					this->process_parsed_tag_name(this->make_token(this->buf, name_begin, i));
+
+					// After parsing usual tag we expect attributes, but since we got '/'
+					// the tag has no any attributes, so it is empty. In other cases, like
+					// '!DOCTYPE' tag the cur_state should remain.
+					if (this->cur_state == state::attributes) {
+						this->cur_state = state::tag_empty;
+					}
+					return;
+				}
+				break;
+			default:
+				break;
+		}
+	}
+	this->buf.insert(std::end(this->buf), name_begin, e);
+}
+
+template <typename handler_type>
+void basic_parser<handler_type>::parse_idle(utki::span<const char>::iterator& i, utki::span<const char>::iterator& e)
+{
+	for (; i != e; ++i) {
+		switch (*i) {
+			case '<':
+				this->cur_state = state::tag;
+				return;
+			case '&':
+				this->state_after_ref_char = state::content;
+				this->cur_state = state::ref_char;
+				return;
+			case '\r':
+				// ignore
+				break;
+			default:
+				ASSERT(this->buf.empty())
+				this->cur_state = state::content;
+				this->parse_content(i, e);
+				return;
+		}
+	}
+}
+
+template <typename handler_type>
+void basic_parser<handler_type>::parse_cdata_terminator(utki::span<const char>::iterator& i, utki::span<const char>::iterator& e)
+{
+	for (; i != e; ++i) {
+		switch (*i) {
+			case ']':
+				ASSERT(!this->buf.empty())
+				ASSERT(this->buf.back() == ']')
+				this->buf.push_back(']');
+				break;
+			case '>':
+				ASSERT(!this->buf.empty())
+				ASSERT(this->buf.back() == ']')
+				if (this->buf.size() < 2 || this->buf[this->buf.size() - 2] != ']') {
+					this->buf.push_back('>');
+					this->cur_state = state::cdata;
+				} else { // CDATA block ended
+					this->report_content(utki::make_span(this->buf.data(), this->buf.size() - 2));
+					this->buf.clear();
+					this->cur_state = state::idle;
+				}
+				return;
+			default:
+				this->buf.push_back(*i);
+				this->cur_state = state::cdata;
+				return;
+		}
+	}
+}
+
+template <typename handler_type>
+void basic_parser<handler_type>::parse_document(utki::span<const char> document)
+{
+	ASSERT(this->cur_state == state::idle)
+
+	parse_timer timer(this->collected_stats);
+
+	if constexpr (stats_enabled) {
+		this->collected_stats.bytes_fed += document.size();
+	}
+
+	if (this->options.detect_encoding) {
+		document = this->input_decoder.decode(document, true);
+	}
+
+	const char* p = document.data();
+	// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+	const char* end = p + document.size();
+
+	try {
+		this->parse_document_range(p, end);
+	} catch (syntax_error& error) {
+		throw malformed_xml(advance(text_position(), document.data(), p), error.what());
+	}
+
+	this->cur_state = state::idle;
+	this->buf.clear();
+	this->name.clear();
+
+	this->update_peak_capacities();
+}
+
+template <typename handler_type>
+void basic_parser<handler_type>::parse_document(const structural_index& index)
+{
+	ASSERT(this->cur_state == state::idle)
+
+	parse_timer timer(this->collected_stats);
+
+	auto document = index.document();
+	if constexpr (stats_enabled) {
+		this->collected_stats.bytes_fed += document.size();
+	}
+
+	const char* begin = document.data();
+	const char* p = begin;
+	// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+	const char* end = begin + document.size();
+
+	auto markup = index.markup();
+	auto escapes = index.escapes();
+	auto next_escape = escapes.begin();
+
+	ASSERT(markup.size() % 2 == 0)
+
+	try {
+		// NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+		for (auto i = markup.begin(); i != markup.end(); i += 2) {
+			const char* markup_begin = begin + *i;
+			const char* markup_end = begin + *std::next(i) + 1;
+
+			if (p != markup_begin) {
+				for (; next_escape != escapes.end() && begin + *next_escape < p; ++next_escape) {
+				}
+
+				if (next_escape == escapes.end() || begin + *next_escape > markup_begin) {
+					// nothing to transform in the content
+					this->report_content(utki::make_span(p, size_t(markup_begin - p)));
+					p = markup_begin;
+				} else {
+					while (p < markup_begin) {
+						if (*p == '\r') {
+							// ignore
+							++p;
+						} else {
+							this->parse_document_content(p, end);
+						}
+					}
+					if (p != markup_begin) {
+						break;
+					}
+				}
+			}
+
+			++p;
+			this->parse_document_markup(p, end);
+			if (p != markup_end) {
+				break;
+			}
+		}
+		// NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+
+		// the rest of the document which is not covered by the index
+		this->parse_document_range(p, end);
+	} catch (syntax_error& error) {
+		throw malformed_xml(advance(text_position(), begin, p), error.what());
+	}
+
+	this->cur_state = state::idle;
+	this->buf.clear();
+	this->name.clear();
+
+	this->update_peak_capacities();
+}
+
+template <typename handler_type>
+void basic_parser<handler_type>::parse_document_range(const char*& p, const char* end)
+{
+	while (p != end) {
+		switch (*p) {
+			case '<':
+				// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+				++p;
+				this->parse_document_markup(p, end);
+				break;
+			case '\r':
+				// ignore
+				// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+				++p;
+				break;
+			default:
+				this->parse_document_content(p, end);
+				break;
+		}
+	}
+}
+
+template <typename handler_type>
+void basic_parser<handler_type>::parse_document_content(const char*& p, const char* end)
+{
+	ASSERT(this->buf.empty())
+
+	while (p != end) {
+		const char* run_begin = p;
+		p = find_first_of(p, end, '<', '&', '\r');
+		if (p == end) {
+			this->buf.insert(std::end(this->buf), run_begin, p);
+			break;
+		}
+
+		auto run = utki::make_span(run_begin, size_t(p - run_begin));
+
+		switch (*p) {
+			case '<':
+				if (this->buf.empty()) {
+					this->report_content(run);
+				} else {
+					this->buf.insert(std::end(this->buf), run.begin(), run.end());
+					this->report_content(utki::make_span(this->buf.data(), this->buf.size()));
+				}
+				this->buf.clear();
+				return;
+			case '&':
+				this->buf.insert(std::end(this->buf), run.begin(), run.end());
+				// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+				++p;
+				this->parse_document_ref_char(p, end);
+				break;
+			default:
+				ASSERT(*p == '\r')
+				// ignore
+				this->buf.insert(std::end(this->buf), run.begin(), run.end());
+				// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+				++p;
+				break;
+		}
+	}
+
+	// the end of the document is reached, same as in feed() mode
+	this->report_unterminated_content(utki::make_span(this->buf.data(), this->buf.size()));
+	this->buf.clear();
+}
+
+template <typename handler_type>
+void basic_parser<handler_type>::parse_document_markup(const char*& p, const char* end)
+{
+	if (starts_with(p, end, comment_tag_word)) {
+		// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+		p += comment_tag_word.size();
+		this->parse_document_comment(p, end);
+		return;
+	}
+
+	if (starts_with(p, end, cdata_tag_word)) {
+		// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+		p += cdata_tag_word.size();
+		this->parse_document_cdata(p, end);
+		return;
+	}
+
+	const char* name_begin = p;
+	// end tag name starts with '/'
+	if (p != end && *p == '/') {
+		// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+		++p;
+	}
+	skip_to_class(p, end, char_class::tag_name_end);
+	auto tag_name = utki::make_span(name_begin, size_t(p - name_begin));
+
+	this->process_parsed_tag_name(tag_name);
+
+	// end of the document terminates the tag name same way as a whitespace
+	char terminator = '\n';
+	if (p != end) {
+		terminator = *p;
+		// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+		++p;
+	}
+
+	switch (terminator) {
+		case '>':
+			if (this->cur_state == state::attributes) {
+				this->handler().on_attributes_end(false);
+			}
+			this->cur_state = state::idle;
+			return;
+		case '/':
+			if (this->cur_state == state::attributes) {
+				this->parse_document_tag_empty(p, end);
+				this->cur_state = state::idle;
+				return;
+			}
+			break;
+		default:
+			break;
+	}
+
+	switch (this->cur_state) {
+		case state::attributes:
+			this->parse_document_attributes(p, end);
+			break;
+		case state::tag_seek_gt:
+			p = skip_whitespace(p, end);
+			if (p != end) {
+				if (*p != '>') {
+					std::stringstream ss;
+					ss << "unexpected character encountered (" << *p << "), expected '>'.";
+					throw syntax_error(ss.str());
+				}
+				// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+				++p;
+			}
+			break;
+		case state::declaration:
+			this->parse_document_declaration(p, end);
+			break;
+		case state::doctype:
+			this->parse_document_doctype(p, end);
+			break;
+		default:
+			ASSERT(this->cur_state == state::skip_unknown_exclamation_mark_construct)
+			p = find(p, end, '>');
+			if (p != end) {
+				// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+				++p;
+			}
+			break;
+	}
+	this->cur_state = state::idle;
+}
+
+template <typename handler_type>
+void basic_parser<handler_type>::parse_document_tag_empty(const char*& p, const char* end)
+{
+	// end of the document is same as a new line character which is unexpected here
+	if (p == end || *p != '>') {
+		throw syntax_error("unexpected '/' character in attribute list encountered.");
+	}
+	// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+	++p;
+	this->handler().on_attributes_end(true);
+	this->leave_element();
+	this->cur_name_id = name_table::unknown;
+	this->handler().on_element_end(utki::make_span<char>(nullptr, 0));
+}
+
+template <typename handler_type>
+void basic_parser<handler_type>::parse_document_attributes(const char*& p, const char* end)
+{
+	for (;;) {
+		p = skip_whitespace(p, end);
+		if (p == end) {
+			return;
+		}
+
+		switch (*p) {
+			case '/':
+				// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+				++p;
+				this->parse_document_tag_empty(p, end);
+				return;
+			case '>':
+				// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+				++p;
+				this->handler().on_attributes_end(false);
+				return;
+			case '=':
+				throw syntax_error("unexpected '=' encountered");
+			default:
+				if (!this->parse_document_attribute(p, end)) {
+					return;
+				}
+				break;
+		}
+	}
+}
+
+template <typename handler_type>
+bool basic_parser<handler_type>::parse_document_attribute(const char*& p, const char* end)
+{
+	const char* name_begin = p;
+	skip_to_class(p, end, char_class::attribute_name_end);
+	auto attr_name = utki::make_span(name_begin, size_t(p - name_begin));
+	this->check_name_length(attr_name);
+
+	p = skip_whitespace(p, end);
+	if (p == end) {
+		return false;
+	}
+	if (*p != '=') {
+		std::stringstream ss;
+		ss << "unexpected character encountered (0x" << std::hex << unsigned(*p) << "), expected '='";
+		throw syntax_error(ss.str());
+	}
+	// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+	++p;
+
+	p = skip_whitespace(p, end);
+	if (p == end) {
+		return false;
+	}
+	char quote = *p;
+	if (quote != '\'' && quote != '"') {
+		throw syntax_error(R"(unexpected character encountered, expected "'" or '"'.)");
+	}
+	// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+	++p;
+
+	ASSERT(this->buf.empty())
+
+	while (p != end) {
+		const char* run_begin = p;
+		p = find_first_of(p, end, quote, '&', '\r');
+		if (p == end) {
+			break;
+		}
+
+		auto run = utki::make_span(run_begin, size_t(p - run_begin));
+
+		switch (*p) {
+			case '&':
+				this->buf.insert(std::end(this->buf), run.begin(), run.end());
+				// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+				++p;
+				this->parse_document_ref_char(p, end);
+				break;
+			case '\r':
+				// ignore
+				this->buf.insert(std::end(this->buf), run.begin(), run.end());
+				// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+				++p;
+				break;
+			default:
+				ASSERT(*p == quote)
+				this->lookup_name_id(attr_name);
+				if constexpr (stats_enabled) {
+					++this->collected_stats.num_attributes;
+				}
+				if (this->buf.empty()) {
+					this->check_token_length(run.size());
+					this->handler().on_attribute_parsed(attr_name, run);
+				} else {
+					this->buf.insert(std::end(this->buf), run.begin(), run.end());
+					this->check_token_length(this->buf.size());
+					this->handler().on_attribute_parsed(attr_name, utki::make_span(this->buf.data(), this->buf.size()));
+					this->buf.clear();
+				}
+				// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+				++p;
+				return true;
+		}
+	}
+
+	// unterminated attribute value is not reported
+	this->buf.clear();
+	return false;
+}
+
+template <typename handler_type>
+void basic_parser<handler_type>::parse_document_cdata(const char*& p, const char* end)
+{
+	using namespace std::string_view_literals;
+
+	const char* cdata_begin = p;
+	const char* cdata_end = find(p, end, "]]>"sv);
+	if (cdata_end == end) {
+		this->report_unterminated_content(utki::make_span(cdata_begin, size_t(end - cdata_begin)));
+		p = end;
+		return;
+	}
+
+	// same as in feed(), the CDATA is reported when its terminating '>' is reached
+	// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+	p = cdata_end + "]]"sv.size();
+	this->report_content(utki::make_span(cdata_begin, size_t(cdata_end - cdata_begin)));
+	// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+	++p;
+}
+
+} // namespace mikroxml
@@ -0,0 +1,173 @@
+/*
+MIT License
+
+Copyright (c) 2017-2026 Ivan Gagis
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* ================ LICENSE END ================ */
+
+#include "batch.hpp"
+
+#include <algorithm>
+
+using namespace mikroxml;
+
+namespace {
+// the documents are taken by the threads in groups of at most this size
+constexpr size_t max_claim_size = 64;
+
+// desired number of groups per thread, so that the threads finishing early
+// can take the documents which would otherwise be parsed by the slower ones
+constexpr size_t claims_per_thread = 16;
+} // namespace
+
+batch_parser::batch_parser(
+	const std::function<std::unique_ptr<batch_handler>()>& make_handler, //
+	const batch_options& options
+)
+{
+	unsigned num_threads = options.num_threads != 0 ? options.num_threads : std::thread::hardware_concurrency();
+	num_threads = std::max(num_threads, 1u);
+
+	for (unsigned i = 0; i != num_threads; ++i) {
+		auto h = make_handler();
+		utki::assert(h != nullptr, SL);
+		this->handlers.push_back(std::move(h));
+	}
+
+	// the first handler is used by the thread calling parse()
+	try {
+		for (auto i = std::next(this->handlers.begin()); i != this->handlers.end(); ++i) {
+			auto& handler = **i;
+			this->threads.emplace_back([this, &handler]() {
+				this->run(handler);
+			});
+		}
+	} catch (...) {
+		this->stop();
+		throw;
+	}
+}
+
+batch_parser::~batch_parser() noexcept
+{
+	this->stop();
+}
+
+void batch_parser::stop() noexcept
+{
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		this->quit = true;
+	}
+	this->work_cv.notify_all();
+
+	for (auto& t : this->threads) {
+		t.join();
+	}
+	this->threads.clear();
+}
+
+void batch_parser::run(batch_handler& handler)
+{
+	unsigned last_batch_number = 0;
+	for (;;) {
+		{
+			std::unique_lock<std::mutex> lock(this->mutex);
+			this->work_cv.wait(lock, [this, last_batch_number]() {
+				return this->quit || this->batch_number != last_batch_number;
+			});
+			if (this->quit) {
+				return;
+			}
+			last_batch_number = this->batch_number;
+		}
+
+		this->parse_documents(handler);
+
+		{
+			std::lock_guard<std::mutex> lock(this->mutex);
+			--this->num_busy_threads;
+		}
+		this->done_cv.notify_all();
+	}
+}
+
+void batch_parser::parse_documents(batch_handler& handler) noexcept
+{
+	auto num_documents = this->documents.size();
+	auto claim_size = this->claim_size;
+
+	for (;;) {
+		auto begin = this->next_document.fetch_add(claim_size, std::memory_order_relaxed);
+		if (begin >= num_documents) {
+			return;
+		}
+		auto end = std::min(begin + claim_size, num_documents);
+
+		for (auto i = begin; i != end; ++i) {
+			try {
+				handler.reset();
+				handler.on_document_start(i);
+				handler.parse_document(this->documents[i]);
+				handler.on_document_end(i);
+			} catch (...) {
+				(*this->errors)[i] = std::current_exception();
+			}
+		}
+	}
+}
+
+std::vector<std::exception_ptr> batch_parser::parse(utki::span<const utki::span<const char>> documents)
+{
+	std::vector<std::exception_ptr> errors(documents.size());
+	if (documents.empty()) {
+		return errors;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		this->documents = documents;
+		this->errors = &errors;
+		this->next_document.store(0, std::memory_order_relaxed);
+		this->claim_size = std::clamp(
+			documents.size() / (this->handlers.size() * claims_per_thread), //
+			size_t(1),
+			max_claim_size
+		);
+		this->num_busy_threads = unsigned(this->threads.size());
+		++this->batch_number;
+	}
+	this->work_cv.notify_all();
+
+	this->parse_documents(*this->handlers.front());
+
+	{
+		std::unique_lock<std::mutex> lock(this->mutex);
+		this->done_cv.wait(lock, [this]() {
+			return this->num_busy_threads == 0;
+		});
+		this->documents = {};
+		this->errors = nullptr;
+	}
+
+	return errors;
+}
@@ -0,0 +1,177 @@
+/*
+MIT License
+
+Copyright (c) 2017-2026 Ivan Gagis
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* ================ LICENSE END ================ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "mikroxml.hpp"
+
+namespace mikroxml {
+
+/**
+ * @brief Handler of the documents parsed by the batch_parser.
+ * Besides the usual parser events, the handler is notified about the beginning
+ * and the end of each document it parses.
+ */
+class batch_handler : public parser
+{
+public:
+	explicit batch_handler(const parser_options& options = {}) :
+		parser(options)
+	{}
+
+	/**
+	 * @brief Document parsing start notification.
+	 * The parser state of the handler is reset by parser_base::reset() before the notification,
+	 * so no parsing state is left from the previously parsed document. The handler's own members
+	 * are not reset, the handler can override this method to clear them.
+	 * @param index - index of the document in the batch.
+	 */
+	virtual void on_document_start(size_t index) {}
+
+	/**
+	 * @brief Document parsed notification.
+	 * Called only if the document was parsed without errors.
+	 * @param index - index of the document in the batch.
+	 */
+	virtual void on_document_end(size_t index) {}
+};
+
+/**
+ * @brief Batch parsing options.
+ */
+struct batch_options {
+	/**
+	 * @brief Number of parsing threads, including the thread calling batch_parser::parse().
+	 * Zero means the number of hardware threads.
+	 */
+	unsigned num_threads = 0;
+};
+
+/**
+ * @brief Parser of many independent in-memory documents.
+ * Parses batches of complete documents using a pool of threads. Each thread has its own
+ * handler, created once by the handler factory, which is reset and reused for each document
+ * the thread parses, so that parsing of small documents does not pay for the parser setup.
+ * The threads take the documents from the batch in small groups until the batch is exhausted,
+ * so that the threads which get smaller documents take more of them.
+ * The threads are kept between the parse() calls.
+ */
+class batch_parser
+{
+	std::vector<std::unique_ptr<batch_handler>> handlers;
+
+	std::mutex mutex;
+
+	// signalled when a batch is started or the parser is destroyed
+	std::condition_variable work_cv;
+
+	// signalled when a thread has finished its part of the batch
+	std::condition_variable done_cv;
+
+	// incremented each time a batch is started
+	unsigned batch_number = 0;
+	bool quit = false;
+
+	// number of threads still parsing the current batch
+	unsigned num_busy_threads = 0;
+
+	utki::span<const utki::span<const char>> documents;
+	std::vector<std::exception_ptr>* errors = nullptr;
+
+	// index of the next document of the batch to take
+	std::atomic<size_t> next_document{0};
+
+	// number of documents taken by a thread at a time
+	size_t claim_size = 1;
+
+	std::vector<std::thread> threads;
+
+	void run(batch_handler& handler);
+	void stop() noexcept;
+	void parse_documents(batch_handler& handler) noexcept;
+
+public:
+	/**
+	 * @brief Constructor.
+	 * @param make_handler - factory of the handlers, called once for each thread.
+	 * @param options - batch parsing options.
+	 */
+	explicit batch_parser(
+		const std::function<std::unique_ptr<batch_handler>()>& make_handler, //
+		const batch_options& options = {}
+	);
+
+	batch_parser(const batch_parser&) = delete;
+	batch_parser& operator=(const batch_parser&) = delete;
+
+	batch_parser(batch_parser&&) = delete;
+	batch_parser& operator=(batch_parser&&) = delete;
+
+	~batch_parser() noexcept;
+
+	/**
+	 * @brief Parse batch of documents.
+	 * The handlers' callbacks are called from different threads, but each handler is used
+	 * by one thread at a time. The call returns when all the documents are parsed.
+	 * Only one batch can be parsed at a time.
+	 * @param documents - the documents to parse.
+	 * @return Error of each document, null for successfully parsed documents.
+	 *         Parsing errors are reported as malformed_xml, exceptions thrown by the handler's
+	 *         callbacks are reported as is.
+	 */
+	std::vector<std::exception_ptr> parse(utki::span<const utki::span<const char>> documents);
+
+	/**
+	 * @brief Get number of parsing threads.
+	 * @return Number of parsing threads, including the thread calling parse().
+	 */
+	size_t num_threads() const noexcept
+	{
+		return this->handlers.size();
+	}
+
+	/**
+	 * @brief Get handler of a thread.
+	 * Can be used to collect the results accumulated by the handlers after the batch is parsed.
+	 * @param thread_index - index of the thread, less than num_threads().
+	 * @return Handler used by the thread.
+	 */
+	batch_handler& get_handler(size_t thread_index) noexcept
+	{
+		return *this->handlers[thread_index];
+	}
+};
+
+} // namespace mikroxml
@@ -0,0 +1,164 @@
+/*
+MIT License
+
+Copyright (c) 2017-2026 Ivan Gagis
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* ================ LICENSE END ================ */
+
+#include "document.hpp"
+
+#include <algorithm>
+
+using namespace mikroxml;
+
+namespace {
+constexpr size_t min_string_block_size = 0x1000; // 4kb
+
+// approximate number of document bytes per node and per attribute
+constexpr size_t average_node_size = 32;
+constexpr size_t average_attribute_size = 32;
+} // namespace
+
+document::document() :
+	nodes{
+		{node_type::root, null_node, null_node, null_node, 0, 0, {}}
+}
+{}
+
+std::string_view document::store(utki::span<const char> str)
+{
+	if (str.empty()) {
+		return {};
+	}
+
+	if (this->string_blocks.empty() ||
+		this->string_blocks.back().capacity() - this->string_blocks.back().size() < str.size())
+	{
+		// grow the blocks geometrically to keep the number of blocks small
+		size_t block_size = this->string_blocks.empty() ? min_string_block_size : this->string_blocks.back().capacity() * 2;
+		this->string_blocks.emplace_back();
+		this->string_blocks.back().reserve(std::max(block_size, str.size()));
+	}
+
+	auto& block = this->string_blocks.back();
+	auto offset = block.size();
+	// there is enough capacity, so the block is not reallocated
+	block.insert(std::end(block), std::begin(str), std::end(str));
+	// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+	return {block.data() + offset, str.size()};
+}
+
+const document::attribute* document::find_attribute(node_id n, std::string_view name) const noexcept
+{
+	auto attributes = this->attributes(n);
+	auto i = std::find_if(attributes.begin(), attributes.end(), [&name](const auto& a) {
+		return a.name == name;
+	});
+	if (i == attributes.end()) {
+		return nullptr;
+	}
+	return &*i;
+}
+
+document document::parse(utki::span<const char> data, const parser_options& options)
+{
+	document_builder builder(options);
+
+	// the strings are not longer than the document unless DOCTYPE entities are used,
+	// so most likely all the strings will fit into a single block
+	builder.doc.string_blocks.emplace_back();
+	builder.doc.string_blocks.back().reserve(std::max(min_string_block_size, data.size()));
+
+	// rough estimate of the numbers of nodes and attributes to avoid most of the reallocations
+	builder.doc.nodes.reserve(data.size() / average_node_size + 1);
+	builder.doc.attrs.reserve(data.size() / average_attribute_size);
+
+	builder.parse_document(data);
+
+	return builder.release();
+}
+
+document_builder::document_builder(const parser_options& options) :
+	basic_parser<document_builder>(options),
+	open_elements{
+		{0, document::null_node}
+}
+{}
+
+document::node_id document_builder::add_node(document::node_type type, utki::span<const char> str)
+{
+	auto id = document::node_id(this->doc.nodes.size());
+	auto& parent = this->open_elements.back();
+
+	auto attributes_end = uint32_t(this->doc.attrs.size());
+
+	this->doc.nodes.push_back(
+		{type, parent.id, document::null_node, document::null_node, attributes_end, attributes_end, this->doc.store(str)}
+	);
+
+	if (parent.last_child == document::null_node) {
+		this->doc.nodes[parent.id].first_child = id;
+	} else {
+		this->doc.nodes[parent.last_child].next_sibling = id;
+	}
+	parent.last_child = id;
+
+	return id;
+}
+
+void document_builder::on_element_start(utki::span<const char> name)
+{
+	auto id = this->add_node(document::node_type::element, name);
+	this->open_elements.push_back({id, document::null_node});
+}
+
+void document_builder::on_element_end(utki::span<const char> name)
+{
+	// the root node is never closed
+	if (this->open_elements.size() > 1) {
+		this->open_elements.pop_back();
+	}
+}
+
+void document_builder::on_attributes_end(bool is_empty_element) {}
+
+void document_builder::on_attribute_parsed(utki::span<const char> name, utki::span<const char> value)
+{
+	// attributes are reported right after the element start, so all of them go
+	// to the same contiguous range, and the element is the last added node
+	this->doc.attrs.push_back({this->doc.store(name), this->doc.store(value)});
+	this->doc.nodes.back().attributes_end = uint32_t(this->doc.attrs.size());
+}
+
+void document_builder::on_content_parsed(utki::span<const char> str)
+{
+	this->add_node(document::node_type::content, str);
+}
+
+document document_builder::release()
+{
+	auto ret = std::move(this->doc);
+	this->doc = document();
+	this->open_elements.resize(1);
+	this->open_elements.front().last_child = document::null_node;
+	return ret;
+}
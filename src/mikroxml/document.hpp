@@ -0,0 +1,238 @@
+/*
+MIT License
+
+Copyright (c) 2017-2026 Ivan Gagis
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* ================ LICENSE END ================ */
+
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "basic_parser.hpp"
+
+namespace mikroxml {
+
+/**
+ * @brief Parsed XML document tree.
+ * The nodes are stored contiguously in document order and refer to each other
+ * by indices. All names, attribute values and content strings are stored in a
+ * few large memory blocks owned by the document, so building and destroying
+ * the document takes few memory allocations regardless of the number of nodes.
+ * The document is movable, but not copyable.
+ */
+class document
+{
+	friend class document_builder;
+
+public:
+	using node_id = uint32_t;
+
+	/**
+	 * @brief Invalid node id.
+	 * Returned by navigation methods when there is no such node.
+	 */
+	static constexpr node_id null_node = ~node_id(0);
+
+	enum class node_type : uint8_t {
+		/**
+		 * @brief The document root.
+		 * The top level elements and content are children of the root node.
+		 */
+		root,
+		element,
+		content
+	};
+
+	struct attribute {
+		std::string_view name;
+		std::string_view value;
+	};
+
+private:
+	struct node {
+		node_type type;
+		node_id parent;
+		node_id first_child;
+		node_id next_sibling;
+		uint32_t attributes_begin;
+		uint32_t attributes_end;
+
+		// element name or content
+		std::string_view str;
+	};
+
+	std::vector<node> nodes;
+	std::vector<attribute> attrs;
+
+	// the strings storage, the blocks are never reallocated, so the string views stay valid
+	std::vector<std::vector<char>> string_blocks;
+
+	std::string_view store(utki::span<const char> str);
+
+public:
+	/**
+	 * @brief Construct empty document.
+	 * The empty document consists of the root node only.
+	 */
+	document();
+
+	document(const document&) = delete;
+	document& operator=(const document&) = delete;
+
+	document(document&&) = default;
+	document& operator=(document&&) = default;
+
+	~document() = default;
+
+	/**
+	 * @brief Parse complete in-memory XML document.
+	 * @param data - the document to parse. The data is not referred to by the resulting document.
+	 * @param options - parser options.
+	 * @return The parsed document.
+	 * @throw malformed_xml - in case of malformed XML document.
+	 */
+	static document parse(utki::span<const char> data, const parser_options& options = {});
+
+	node_id root() const noexcept
+	{
+		return 0;
+	}
+
+	/**
+	 * @brief Get total number of nodes.
+	 * Node ids are in range [0, size()), in document order.
+	 * @return Number of nodes including the root node.
+	 */
+	size_t size() const noexcept
+	{
+		return this->nodes.size();
+	}
+
+	node_type type(node_id n) const noexcept
+	{
+		return this->nodes[n].type;
+	}
+
+	/**
+	 * @brief Get element name.
+	 * @param n - node id.
+	 * @return Name of the element, or empty string if the node is not an element.
+	 */
+	std::string_view name(node_id n) const noexcept
+	{
+		return this->nodes[n].type == node_type::element ? this->nodes[n].str : std::string_view();
+	}
+
+	/**
+	 * @brief Get content.
+	 * @param n - node id.
+	 * @return The content, or empty string if the node is not a content node.
+	 */
+	std::string_view content(node_id n) const noexcept
+	{
+		return this->nodes[n].type == node_type::content ? this->nodes[n].str : std::string_view();
+	}
+
+	node_id parent(node_id n) const noexcept
+	{
+		return this->nodes[n].parent;
+	}
+
+	node_id first_child(node_id n) const noexcept
+	{
+		return this->nodes[n].first_child;
+	}
+
+	node_id next_sibling(node_id n) const noexcept
+	{
+		return this->nodes[n].next_sibling;
+	}
+
+	/**
+	 * @brief Get element attributes.
+	 * @param n - node id.
+	 * @return The attributes in document order, empty if the node is not an element.
+	 */
+	utki::span<const attribute> attributes(node_id n) const noexcept
+	{
+		const auto& nd = this->nodes[n];
+		return utki::make_span(
+			// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+			this->attrs.data() + nd.attributes_begin,
+			nd.attributes_end - nd.attributes_begin
+		);
+	}
+
+	/**
+	 * @brief Find attribute by name.
+	 * @param n - element node id.
+	 * @param name - attribute name.
+	 * @return Pointer to the first attribute with the given name, or nullptr if there is no such attribute.
+	 */
+	const attribute* find_attribute(node_id n, std::string_view name) const noexcept;
+};
+
+/**
+ * @brief Parser building the document tree.
+ * Feed the data and call end(), then take the built document with release().
+ * The builder is as lenient as the parser, i.e. end tag names are not checked
+ * against the start tag names, unmatched end tags at the top level are ignored,
+ * and the elements which are not ended by the end of the data are considered complete.
+ */
+class document_builder : public basic_parser<document_builder>
+{
+	friend class basic_parser<document_builder>;
+	friend class document;
+
+	document doc;
+
+	struct open_element {
+		document::node_id id;
+		document::node_id last_child;
+	};
+
+	// path from the root node to the current element
+	std::vector<open_element> open_elements;
+
+	document::node_id add_node(document::node_type type, utki::span<const char> str);
+
+	void on_element_start(utki::span<const char> name);
+	void on_element_end(utki::span<const char> name);
+	void on_attributes_end(bool is_empty_element);
+	void on_attribute_parsed(utki::span<const char> name, utki::span<const char> value);
+	void on_content_parsed(utki::span<const char> str);
+
+public:
+	explicit document_builder(const parser_options& options = {});
+
+	/**
+	 * @brief Take the built document.
+	 * The builder is left with an empty document.
+	 * @return The built document.
+	 */
+	document release();
+};
+
+} // namespace mikroxml
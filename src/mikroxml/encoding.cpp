@@ -0,0 +1,568 @@
+/*
+MIT License
+
+Copyright (c) 2017-2026 Ivan Gagis
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* ================ LICENSE END ================ */
+
+#include "encoding.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include <utki/debug.hpp>
+
+#if defined(__SSE2__)
+#	include <emmintrin.h>
+#endif
+
+using namespace mikroxml;
+
+namespace {
+// the encoding declaration is not looked for beyond that
+constexpr size_t max_declaration_length = 0x400; // 1kb
+
+constexpr char32_t replacement_character = 0xfffd;
+
+constexpr size_t utf16_unit_size = 2;
+
+// maximal number of UTF-8 bytes per UTF-16 code unit
+constexpr size_t max_utf8_bytes_per_utf16_unit = 3;
+
+// known beginnings of the input, see appendix F of the XML specification
+struct signature {
+	std::string_view bytes;
+	encoding enc;
+	size_t bom_size;
+};
+
+const std::array<signature, 5> signatures = {
+	{
+		{"\xef\xbb\xbf", encoding::utf8, 3},
+		{"\xff\xfe", encoding::utf16le, 2},
+		{"\xfe\xff", encoding::utf16be, 2},
+		// "<?" without byte order mark
+		{std::string_view("<\0?\0", 4), encoding::utf16le, 0},
+		{std::string_view("\0<\0?", 4), encoding::utf16be, 0},
+	}
+};
+
+constexpr std::string_view declaration_start = "<?xml";
+constexpr std::string_view declaration_end = "?>";
+
+enum class match {
+	none,
+	partial,
+	full
+};
+
+// partial match means that the data is shorter than the signature and matches its beginning
+match match_signature(std::string_view data, std::string_view signature) noexcept
+{
+	size_t size = std::min(data.size(), signature.size());
+	if (data.substr(0, size) != signature.substr(0, size)) {
+		return match::none;
+	}
+	return size == signature.size() ? match::full : match::partial;
+}
+
+bool is_whitespace(char c) noexcept
+{
+	return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+char to_lower(char c) noexcept
+{
+	return c >= 'A' && c <= 'Z' ? char(c - 'A' + 'a') : c;
+}
+
+// returns the encoding declared by the XML declaration, the declaration is read as single-byte characters
+encoding parse_declared_encoding(std::string_view declaration)
+{
+	constexpr std::string_view attribute_name = "encoding";
+
+	auto i = declaration.find(attribute_name);
+	if (i == std::string_view::npos) {
+		return encoding::utf8;
+	}
+	i += attribute_name.size();
+
+	auto skip_whitespace = [&]() {
+		for (; i != declaration.size() && is_whitespace(declaration[i]); ++i) {
+		}
+	};
+
+	skip_whitespace();
+	if (i == declaration.size() || declaration[i] != '=') {
+		return encoding::utf8;
+	}
+	++i;
+	skip_whitespace();
+	if (i == declaration.size() || (declaration[i] != '"' && declaration[i] != '\'')) {
+		return encoding::utf8;
+	}
+
+	auto value_end = declaration.find(declaration[i], i + 1);
+	if (value_end == std::string_view::npos) {
+		return encoding::utf8;
+	}
+
+	auto name = declaration.substr(i + 1, value_end - i - 1);
+	switch (decoder::from_name(name)) {
+		case encoding::unknown:
+			throw std::invalid_argument(std::string("unsupported encoding: ").append(name));
+		case encoding::latin1:
+			return encoding::latin1;
+		default:
+			// the declaration has been read as single-byte characters,
+			// so the input cannot be UTF-16 regardless of what is declared
+			return encoding::utf8;
+	}
+}
+
+// detects the encoding from the beginning of the input,
+// returns encoding::unknown if more input is needed
+signature detect(std::string_view data, bool is_last)
+{
+	const signature need_more_data = {{}, encoding::unknown, 0};
+	const signature utf8 = {{}, encoding::utf8, 0};
+
+	bool is_partial = false;
+
+	for (const auto& s : signatures) {
+		switch (match_signature(data, s.bytes)) {
+			case match::full:
+				return s;
+			case match::partial:
+				is_partial = true;
+				break;
+			case match::none:
+				break;
+		}
+	}
+
+	switch (match_signature(data, declaration_start)) {
+		case match::full:
+			{
+				auto end = data.find(declaration_end);
+				if (end == std::string_view::npos) {
+					if (!is_last && data.size() < max_declaration_length) {
+						return need_more_data;
+					}
+					return utf8;
+				}
+				return {{}, parse_declared_encoding(data.substr(0, end)), 0};
+			}
+		case match::partial:
+			is_partial = true;
+			break;
+		case match::none:
+			break;
+	}
+
+	if (is_partial && !is_last) {
+		return need_more_data;
+	}
+	return utf8;
+}
+
+char* encode_utf8(char32_t c, char* out) noexcept
+{
+	// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers, cppcoreguidelines-pro-bounds-pointer-arithmetic)
+	if (c < 0x80) {
+		*out++ = char(c);
+	} else if (c < 0x800) {
+		*out++ = char(0xc0 | (c >> 6));
+		*out++ = char(0x80 | (c & 0x3f));
+	} else if (c < 0x10000) {
+		*out++ = char(0xe0 | (c >> 12));
+		*out++ = char(0x80 | ((c >> 6) & 0x3f));
+		*out++ = char(0x80 | (c & 0x3f));
+	} else {
+		*out++ = char(0xf0 | (c >> 18));
+		*out++ = char(0x80 | ((c >> 12) & 0x3f));
+		*out++ = char(0x80 | ((c >> 6) & 0x3f));
+		*out++ = char(0x80 | (c & 0x3f));
+	}
+	// NOLINTEND(cppcoreguidelines-avoid-magic-numbers, cppcoreguidelines-pro-bounds-pointer-arithmetic)
+	return out;
+}
+
+// the output must have room for twice the input size
+char* latin1_to_utf8(const char* p, const char* end, char* out) noexcept
+{
+	// NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+#if defined(__SSE2__)
+	{
+		constexpr auto block_size = sizeof(__m128i);
+
+		while (size_t(end - p) >= block_size) {
+			// NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+			auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+
+			// the block is stored as is, the ASCII characters preceding the first non-ASCII one are already in place,
+			// the output has enough room since each of the remaining input characters takes at least one byte
+			// NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(out), block);
+
+			auto mask = unsigned(_mm_movemask_epi8(block));
+			if (mask == 0) {
+				p += block_size;
+				out += block_size;
+				continue;
+			}
+
+			auto num_ascii = unsigned(__builtin_ctz(mask));
+			p += num_ascii;
+			out += num_ascii;
+			out = encode_utf8(char32_t(uint8_t(*p)), out);
+			++p;
+		}
+	}
+#endif
+
+	for (; p != end; ++p) {
+		out = encode_utf8(char32_t(uint8_t(*p)), out);
+	}
+	return out;
+	// NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+}
+
+template <bool is_big_endian>
+char16_t read_utf16_unit(const char* p) noexcept
+{
+	// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers, cppcoreguidelines-pro-bounds-pointer-arithmetic)
+	auto first = unsigned(uint8_t(p[0]));
+	auto second = unsigned(uint8_t(p[1]));
+	if constexpr (is_big_endian) {
+		return char16_t((first << 8) | second);
+	} else {
+		return char16_t((second << 8) | first);
+	}
+	// NOLINTEND(cppcoreguidelines-avoid-magic-numbers, cppcoreguidelines-pro-bounds-pointer-arithmetic)
+}
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers)
+bool is_high_surrogate(char16_t unit) noexcept
+{
+	return (unit & 0xfc00) == 0xd800;
+}
+
+bool is_low_surrogate(char16_t unit) noexcept
+{
+	return (unit & 0xfc00) == 0xdc00;
+}
+
+char32_t combine_surrogates(char16_t high, char16_t low) noexcept
+{
+	return 0x10000 + ((char32_t(high) - 0xd800) << 10) + (char32_t(low) - 0xdc00);
+}
+
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers)
+
+// decodes the code point starting at p, there must be at least one complete code unit,
+// returns the position after the decoded code point, or p if the code point is incomplete
+// and there is more input to come
+template <bool is_big_endian>
+const char* decode_utf16_code_point(const char* p, const char* end, char*& out, bool is_last) noexcept
+{
+	// NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+	auto unit = read_utf16_unit<is_big_endian>(p);
+
+	if (is_high_surrogate(unit)) {
+		if (size_t(end - p) < 2 * utf16_unit_size) {
+			if (!is_last) {
+				return p;
+			}
+			out = encode_utf8(replacement_character, out);
+			return p + utf16_unit_size;
+		}
+
+		auto low = read_utf16_unit<is_big_endian>(p + utf16_unit_size);
+		if (is_low_surrogate(low)) {
+			out = encode_utf8(combine_surrogates(unit, low), out);
+			return p + 2 * utf16_unit_size;
+		}
+
+		// unpaired high surrogate, the next code unit is decoded on its own
+		out = encode_utf8(replacement_character, out);
+		return p + utf16_unit_size;
+	}
+
+	out = encode_utf8(is_low_surrogate(unit) ? replacement_character : char32_t(unit), out);
+	return p + utf16_unit_size;
+	// NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+}
+
+// returns the position of the first undecoded byte, which is either an incomplete code unit
+// or a high surrogate waiting for the rest of the input
+template <bool is_big_endian>
+const char* utf16_to_utf8(const char* p, const char* end, char*& out, bool is_last) noexcept
+{
+	// NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+#if defined(__SSE2__)
+	{
+		// two vectors of code units are narrowed into one vector of bytes
+		constexpr auto block_size = 2 * sizeof(__m128i);
+
+		// NOLINTNEXTLINE(cppcoreguidelines-avoid-magic-numbers)
+		const auto non_ascii_bits = _mm_set1_epi16(short(0xff80));
+		const auto zero = _mm_setzero_si128();
+
+		auto load = [](const char* p) {
+			// NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+			auto units = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+			if constexpr (is_big_endian) {
+				// NOLINTNEXTLINE(cppcoreguidelines-avoid-magic-numbers)
+				units = _mm_or_si128(_mm_slli_epi16(units, 8), _mm_srli_epi16(units, 8));
+			}
+			return units;
+		};
+
+		while (size_t(end - p) >= block_size) {
+			auto first = load(p);
+			auto second = load(p + sizeof(__m128i));
+
+			auto is_ascii = _mm_cmpeq_epi16(_mm_and_si128(_mm_or_si128(first, second), non_ascii_bits), zero);
+			if (_mm_movemask_epi8(is_ascii) == 0xffff) {
+				// NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_packus_epi16(first, second));
+				p += block_size;
+				out += sizeof(__m128i);
+				continue;
+			}
+
+			// decode the block one code point at a time, the last code point may extend beyond the block
+			for (const char* block_end = p + block_size; p < block_end;) {
+				auto next = decode_utf16_code_point<is_big_endian>(p, end, out, is_last);
+				if (next == p) {
+					return p;
+				}
+				p = next;
+			}
+		}
+	}
+#endif
+
+	while (size_t(end - p) >= utf16_unit_size) {
+		auto next = decode_utf16_code_point<is_big_endian>(p, end, out, is_last);
+		if (next == p) {
+			break;
+		}
+		p = next;
+	}
+	return p;
+	// NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+}
+} // namespace
+
+template <bool is_big_endian>
+char* decoder::transcode_utf16(const char* p, const char* end, char* out, bool is_last)
+{
+	// NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+
+	// complete the code point left incomplete at the end of the previous input piece
+	while (this->tail_size != 0 && p != end) {
+		// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
+		this->tail[this->tail_size] = *p;
+		++this->tail_size;
+		++p;
+
+		for (;;) {
+			const char* tail_begin = this->tail.data();
+			const char* tail_end = tail_begin + (this->tail_size & ~size_t(1));
+			if (tail_begin == tail_end) {
+				break;
+			}
+
+			auto next = decode_utf16_code_point<is_big_endian>(tail_begin, tail_end, out, false);
+			if (next == tail_begin) {
+				break;
+			}
+			this->tail_size -= size_t(next - tail_begin);
+			std::memmove(this->tail.data(), next, this->tail_size);
+		}
+	}
+
+	if (this->tail_size == 0) {
+		p = utf16_to_utf8<is_big_endian>(p, end, out, is_last);
+
+		ASSERT(size_t(end - p) < this->tail.size())
+		this->tail_size = size_t(end - p);
+		std::copy(p, end, this->tail.begin());
+	}
+
+	if (is_last && this->tail_size != 0) {
+		// the unpaired high surrogate and the incomplete code unit
+		const char* tail_begin = this->tail.data();
+		const char* tail_end = tail_begin + (this->tail_size & ~size_t(1));
+		while (tail_begin != tail_end) {
+			tail_begin = decode_utf16_code_point<is_big_endian>(tail_begin, tail_end, out, true);
+		}
+		if (this->tail_size % 2 != 0) {
+			out = encode_utf8(replacement_character, out);
+		}
+		this->tail_size = 0;
+	}
+
+	return out;
+	// NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+}
+
+utki::span<const char> decoder::transcode(utki::span<const char> data, bool is_last)
+{
+	size_t max_size = 0;
+	switch (this->detected_encoding) {
+		case encoding::latin1:
+			max_size = data.size() * 2;
+			break;
+		case encoding::utf16le:
+		case encoding::utf16be:
+			// the code points completed from the previous input piece and the trailing replacement character
+			// take no more than the extra space
+			{
+				constexpr size_t extra_space = 16;
+				max_size = (data.size() / utf16_unit_size) * max_utf8_bytes_per_utf16_unit + extra_space;
+			}
+			break;
+		default:
+			// UTF-8 is passed through as is
+			return data;
+	}
+
+	if (this->buf.size() < max_size) {
+		this->buf.resize(max_size);
+	}
+
+	const char* p = data.data();
+	// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+	const char* end = p + data.size();
+	char* out = this->buf.data();
+
+	switch (this->detected_encoding) {
+		case encoding::latin1:
+			out = latin1_to_utf8(p, end, out);
+			break;
+		case encoding::utf16le:
+			out = this->transcode_utf16<false>(p, end, out, is_last);
+			break;
+		default:
+			ASSERT(this->detected_encoding == encoding::utf16be)
+			out = this->transcode_utf16<true>(p, end, out, is_last);
+			break;
+	}
+
+	ASSERT(size_t(out - this->buf.data()) <= this->buf.size())
+	return utki::make_span(this->buf.data(), size_t(out - this->buf.data()));
+}
+
+utki::span<const char> decoder::decode(utki::span<const char> data, bool is_last)
+{
+	utki::span<const char> ret;
+
+	if (this->is_detecting) {
+		auto input = data;
+		if (!this->head.empty()) {
+			this->head.insert(std::end(this->head), data.begin(), data.end());
+			input = utki::make_span(this->head.data(), this->head.size());
+		}
+
+		auto detected = detect(std::string_view(input.data(), input.size()), is_last);
+		if (detected.enc == encoding::unknown) {
+			if (this->head.empty()) {
+				this->head.assign(data.begin(), data.end());
+			}
+			return {};
+		}
+
+		this->detected_encoding = detected.enc;
+		this->is_detecting = false;
+
+		if (detected.enc == encoding::utf8 && !this->head.empty()) {
+			// the UTF-8 is returned as is, so move the buffered input out of the way of clearing the head
+			std::swap(this->buf, this->head);
+		}
+
+		ret = this->transcode(input.subspan(detected.bom_size), is_last);
+		this->head.clear();
+	} else {
+		ret = this->transcode(data, is_last);
+	}
+
+	if (is_last) {
+		this->is_detecting = true;
+		this->tail_size = 0;
+	}
+
+	return ret;
+}
+
+void decoder::reset() noexcept
+{
+	this->detected_encoding = encoding::unknown;
+	this->is_detecting = true;
+	this->head.clear();
+	this->tail_size = 0;
+}
+
+encoding decoder::from_name(std::string_view name) noexcept
+{
+	struct known_encoding {
+		std::string_view name;
+		encoding enc;
+	};
+
+	// lower case names and aliases
+	static const std::array<known_encoding, 15> known_encodings = {
+		{
+			{"utf-8", encoding::utf8},
+			{"utf8", encoding::utf8},
+			{"us-ascii", encoding::utf8},
+			{"ascii", encoding::utf8},
+			{"iso-8859-1", encoding::latin1},
+			{"iso_8859-1", encoding::latin1},
+			{"iso8859-1", encoding::latin1},
+			{"latin1", encoding::latin1},
+			{"latin-1", encoding::latin1},
+			{"l1", encoding::latin1},
+			{"cp819", encoding::latin1},
+			{"ibm819", encoding::latin1},
+			// UTF-16 without byte order mark is big-endian, see RFC 2781
+			{"utf-16", encoding::utf16be},
+			{"utf-16le", encoding::utf16le},
+			{"utf-16be", encoding::utf16be},
+		}
+	};
+
+	for (const auto& e : known_encodings) {
+		if (std::equal(name.begin(), name.end(), e.name.begin(), e.name.end(), [](char a, char b) {
+				return to_lower(a) == b;
+			}))
+		{
+			return e.enc;
+		}
+	}
+	return encoding::unknown;
+}
@@ -0,0 +1,132 @@
+/*
+MIT License
+
+Copyright (c) 2017-2026 Ivan Gagis
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* ================ LICENSE END ================ */
+
+#pragma once
+
+#include <array>
+#include <memory_resource>
+#include <string_view>
+#include <vector>
+
+#include <utki/span.hpp>
+
+namespace mikroxml {
+
+/**
+ * @brief Character encoding of the XML input.
+ */
+enum class encoding {
+	unknown,
+	utf8,
+	latin1,
+	utf16le,
+	utf16be
+};
+
+/**
+ * @brief Streaming decoder of the XML input to UTF-8.
+ * The input encoding is detected from the byte order mark or, if there is none,
+ * from the encoding declaration, as described in appendix F of the XML specification.
+ * Input which has neither is UTF-8.
+ * Supported encodings are UTF-8, US-ASCII, ISO-8859-1 (Latin-1) and UTF-16 of either byte order.
+ * The byte order mark takes precedence over the declared encoding.
+ * Until the encoding is detected, the beginning of the input is buffered,
+ * which is at most the XML declaration. After that the UTF-8 input is passed through
+ * without copying and the rest is transcoded piece by piece as it arrives.
+ * The byte order mark is not a part of the decoded data.
+ * Unpaired UTF-16 surrogates and incomplete code units are decoded to U+FFFD,
+ * otherwise the input is not validated.
+ */
+class decoder
+{
+	encoding detected_encoding = encoding::unknown;
+
+	bool is_detecting = true;
+
+	// beginning of the input received before the encoding has been detected
+	std::pmr::vector<char> head;
+
+	// bytes of the UTF-16 code point left incomplete at the end of the previous input piece
+	std::array<char, 4> tail{};
+	size_t tail_size = 0;
+
+	// decoded data, the size of the vector is the capacity available for decoding
+	std::pmr::vector<char> buf;
+
+	utki::span<const char> transcode(utki::span<const char> data, bool is_last);
+
+	template <bool is_big_endian>
+	char* transcode_utf16(const char* p, const char* end, char* out, bool is_last);
+
+public:
+	/**
+	 * @brief Constructor.
+	 * @param memory - memory resource to allocate the buffers from, must outlive the decoder.
+	 */
+	explicit decoder(std::pmr::memory_resource* memory = std::pmr::get_default_resource()) :
+		head(memory),
+		buf(memory)
+	{}
+
+	/**
+	 * @brief Decode next piece of input.
+	 * @param data - next piece of input.
+	 * @param is_last - true if the data is the last piece of the input.
+	 *        After the last piece the decoder is ready for decoding another input,
+	 *        the encoding of which is detected anew.
+	 * @return UTF-8 data decoded so far, possibly empty. Points either into the input data
+	 *         or into the decoder's buffer, valid until the next call.
+	 * @throw std::invalid_argument - if the declared encoding is not supported.
+	 */
+	utki::span<const char> decode(utki::span<const char> data, bool is_last = false);
+
+	/**
+	 * @brief Get the input encoding.
+	 * @return The detected encoding of the last decoded input, or encoding::unknown
+	 *         if nothing has been detected yet.
+	 */
+	encoding get_encoding() const noexcept
+	{
+		return this->detected_encoding;
+	}
+
+	/**
+	 * @brief Reset decoder to its initial state.
+	 * Drops the buffered input, the encoding will be detected from the next decoded data.
+	 */
+	void reset() noexcept;
+
+	/**
+	 * @brief Look up encoding by its name.
+	 * The name is case insensitive, e.g. "UTF-8", "ISO-8859-1", "latin1", "UTF-16LE".
+	 * @param name - encoding name as used in the XML declaration.
+	 * @return The encoding, or encoding::unknown if the encoding is not supported.
+	 *         The "UTF-16" name, which does not specify the byte order, is reported as encoding::utf16be.
+	 */
+	static encoding from_name(std::string_view name) noexcept;
+};
+
+} // namespace mikroxml
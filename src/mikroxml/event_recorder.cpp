@@ -0,0 +1,196 @@
+/*
+MIT License
+
+Copyright (c) 2017-2026 Ivan Gagis
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* ================ LICENSE END ================ */
+
+#include "event_recorder.hpp"
+
+#include <algorithm>
+#include <functional>
+
+#include "mikroxml.hpp"
+
+using namespace mikroxml;
+
+namespace {
+constexpr size_t storage_block_size = 0x1000; // 4kb
+
+parser_options make_recorder_options(const parser_options& options)
+{
+	auto ret = options;
+	// tokens lying within the document are referred to directly, the rest is copied by the recorder anyway
+	ret.zero_copy = true;
+	// the content is recorded whole and replayed as a single chunk
+	ret.stream_content = false;
+	// the recorded tokens refer to the document, so it is parsed as is
+	ret.detect_encoding = false;
+	return ret;
+}
+} // namespace
+
+event_recorder::event_recorder(utki::span<const char> document, const parser_options& options) :
+	basic_parser<event_recorder>(make_recorder_options(options)),
+	document(document)
+{}
+
+utki::span<const char> event_recorder::store(utki::span<const char> str)
+{
+	if (str.empty()) {
+		return str;
+	}
+
+	std::less_equal<const char*> less_equal;
+	// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+	if (less_equal(this->document.data(), str.data()) &&
+		// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+		less_equal(str.data() + str.size(), this->document.data() + this->document.size()))
+	{
+		return str;
+	}
+
+	if (this->storage.empty() || this->storage.back().capacity() - this->storage.back().size() < str.size()) {
+		this->storage.emplace_back();
+		this->storage.back().reserve(std::max(storage_block_size, str.size()));
+	}
+
+	auto& block = this->storage.back();
+	auto offset = block.size();
+	// there is enough capacity, so the block is not reallocated
+	block.insert(std::end(block), std::begin(str), std::end(str));
+	// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+	return utki::make_span(block.data() + offset, str.size());
+}
+
+void event_recorder::clear() noexcept
+{
+	this->events.clear();
+	this->recorded_depth = {};
+
+	// keep the first storage block for reuse
+	if (!this->storage.empty()) {
+		this->storage.resize(1);
+		this->storage.front().clear();
+	}
+}
+
+void event_recorder::on_element_start(utki::span<const char> name)
+{
+	++this->recorded_depth.end;
+	this->recorded_depth.max = std::max(this->recorded_depth.max, this->recorded_depth.end);
+	this->events.push_back({event_type::element_start, false, this->name_id(), this->store(name), {}});
+}
+
+void event_recorder::on_element_end(utki::span<const char> name)
+{
+	--this->recorded_depth.end;
+	this->recorded_depth.min = std::min(this->recorded_depth.min, this->recorded_depth.end);
+	this->events.push_back({event_type::element_end, false, this->name_id(), this->store(name), {}});
+}
+
+void event_recorder::on_attributes_end(bool is_empty_element)
+{
+	this->events.push_back({event_type::attributes_end, is_empty_element, name_table::unknown, {}, {}});
+}
+
+void event_recorder::on_attribute_parsed(utki::span<const char> name, utki::span<const char> value)
+{
+	auto stored_name = this->store(name);
+	this->events.push_back({event_type::attribute_parsed, false, this->name_id(), stored_name, this->store(value)});
+}
+
+void event_recorder::on_content_parsed(utki::span<const char> str)
+{
+	this->events.push_back({event_type::content_parsed, false, name_table::unknown, {}, this->store(str)});
+}
+
+void event_recorder::replay(parser& handler) const
+{
+	for (const auto& e : this->events) {
+		handler.cur_name_id = e.name_id;
+		switch (e.type) {
+			case event_type::element_start:
+				handler.on_element_start(e.name);
+				break;
+			case event_type::element_end:
+				handler.on_element_end(e.name);
+				break;
+			case event_type::attributes_end:
+				handler.on_attributes_end(e.is_empty_element);
+				break;
+			case event_type::attribute_parsed:
+				handler.on_attribute_parsed(e.name, e.value);
+				break;
+			case event_type::content_parsed:
+				if (handler.get_options().stream_content) {
+					handler.on_content_chunk(e.value, true);
+				} else {
+					handler.on_content_parsed(e.value);
+				}
+				break;
+		}
+	}
+}
+
+bool event_recorder::is_outside_markup() const noexcept
+{
+	return this->cur_state == state::idle || this->cur_state == state::content;
+}
+
+bool event_recorder::is_at_tag_start() const noexcept
+{
+	return this->cur_state == state::tag && this->buf.empty();
+}
+
+bool event_recorder::has_doctype_entities() const noexcept
+{
+	return !this->doctype_entities.empty();
+}
+
+text_position event_recorder::get_position() const noexcept
+{
+	return this->chunk_position;
+}
+
+void event_recorder::set_position(const text_position& position) noexcept
+{
+	this->chunk_position = position;
+}
+
+unsigned event_recorder::get_depth() const noexcept
+{
+	return this->depth;
+}
+
+void event_recorder::set_depth(unsigned depth) noexcept
+{
+	this->depth = depth;
+}
+
+void event_recorder::skip_to_idle(const char* skipped_begin, const char* skipped_end, unsigned depth) noexcept
+{
+	this->buf.clear();
+	this->cur_state = state::idle;
+	this->chunk_position = advance(this->chunk_position, skipped_begin, skipped_end);
+	this->depth = depth;
+}
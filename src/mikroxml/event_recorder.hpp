@@ -0,0 +1,187 @@
+/*
+MIT License
+
+Copyright (c) 2017-2026 Ivan Gagis
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* ================ LICENSE END ================ */
+
+#pragma once
+
+#include <vector>
+
+#include "basic_parser.hpp"
+
+namespace mikroxml {
+
+class parser;
+
+/**
+ * @brief Parser which records the parsed events.
+ * Used for deferred reporting of the parsed events, e.g. by the reader and by the
+ * parallel parsing. The tokens which lie within the document are recorded as spans
+ * pointing into the document, other tokens are copied to internal storage.
+ * The recorded spans are valid until the recorded events are cleared.
+ * The recorder always works in zero-copy mode.
+ */
+class event_recorder : public basic_parser<event_recorder>
+{
+	friend class basic_parser<event_recorder>;
+
+public:
+	enum class event_type {
+		element_start,
+		element_end,
+		attributes_end,
+		attribute_parsed,
+		content_parsed
+	};
+
+	struct event {
+		event_type type;
+		bool is_empty_element;
+		unsigned name_id;
+		utki::span<const char> name;
+		utki::span<const char> value;
+	};
+
+	/**
+	 * @brief Change of the element nesting depth over the recorded events.
+	 * The depths are relative to the depth at the beginning of the recording,
+	 * so they can be negative if the recording has started inside of some elements.
+	 */
+	struct depth_range {
+		// depth after the last recorded event
+		int end = 0;
+		int min = 0;
+		int max = 0;
+	};
+
+private:
+	utki::span<const char> document;
+
+	// copies of the tokens which do not lie within the document,
+	// the blocks are never reallocated, so the recorded spans stay valid
+	std::vector<std::vector<char>> storage;
+
+	utki::span<const char> store(utki::span<const char> str);
+
+	depth_range recorded_depth;
+
+	void on_element_start(utki::span<const char> name);
+	void on_element_end(utki::span<const char> name);
+	void on_attributes_end(bool is_empty_element);
+	void on_attribute_parsed(utki::span<const char> name, utki::span<const char> value);
+	void on_content_parsed(utki::span<const char> str);
+
+public:
+	/**
+	 * @brief Recorded events.
+	 */
+	std::vector<event> events;
+
+	/**
+	 * @brief Constructor.
+	 * @param document - the document which is going to be parsed, possibly in parts.
+	 * @param options - parser options. The zero_copy, stream_content and detect_encoding options are ignored,
+	 *        the document must be UTF-8.
+	 */
+	event_recorder(utki::span<const char> document, const parser_options& options);
+
+	/**
+	 * @brief Forget the recorded events.
+	 * Also resets the recorded depth range.
+	 */
+	void clear() noexcept;
+
+	/**
+	 * @brief Report the recorded events to the parser.
+	 * The parser's name_id() reports the recorded name ids during the callbacks.
+	 * In content streaming mode, each recorded content is reported as a single last chunk.
+	 * @param handler - the parser to report the events to.
+	 */
+	void replay(parser& handler) const;
+
+	/**
+	 * @brief Check if the parser is outside of any markup.
+	 * @return true if the parser is between tags.
+	 */
+	bool is_outside_markup() const noexcept;
+
+	/**
+	 * @brief Check if the parser has just encountered a tag start.
+	 * @return true if the last parsed character is '<' which has started a tag.
+	 */
+	bool is_at_tag_start() const noexcept;
+
+	/**
+	 * @brief Check if any DOCTYPE entities were declared.
+	 * @return true if the parsed data has declared some DOCTYPE entities.
+	 */
+	bool has_doctype_entities() const noexcept;
+
+	/**
+	 * @brief Get position of the end of the parsed data.
+	 * @return position in the input right after the last parsed character.
+	 */
+	text_position get_position() const noexcept;
+
+	/**
+	 * @brief Set position of the end of the parsed data.
+	 * Used when the parsing has started in the middle of the document.
+	 * @param position - position the next fed data starts at.
+	 */
+	void set_position(const text_position& position) noexcept;
+
+	/**
+	 * @brief Get the element nesting depth change over the recorded events.
+	 * @return The depth range since construction or last clear() call.
+	 */
+	const depth_range& get_recorded_depth() const noexcept
+	{
+		return this->recorded_depth;
+	}
+
+	/**
+	 * @brief Get the element nesting depth the parser is at.
+	 * @return Number of currently open elements.
+	 */
+	unsigned get_depth() const noexcept;
+
+	/**
+	 * @brief Set the element nesting depth the parser is at.
+	 * Used when the parsing has started in the middle of the document.
+	 * @param depth - number of currently open elements.
+	 */
+	void set_depth(unsigned depth) noexcept;
+
+	/**
+	 * @brief Continue parsing outside of any markup.
+	 * Used when part of the document has been skipped without parsing.
+	 * Any partially parsed content is dropped.
+	 * @param skipped_begin - beginning of the skipped part of the document.
+	 * @param skipped_end - end of the skipped part of the document.
+	 * @param depth - element nesting depth at the end of the skipped part of the document.
+	 */
+	void skip_to_idle(const char* skipped_begin, const char* skipped_end, unsigned depth) noexcept;
+};
+
+} // namespace mikroxml
@@ -26,111 +26,27 @@ SOFTWARE.
 
 #pragma once
 
-#include <map>
-#include <vector>
-
-#include <utki/span.hpp>
+#include "basic_parser.hpp"
 
 namespace mikroxml {
 
-class malformed_xml : public std::logic_error
-{
-public:
-	malformed_xml(
-		unsigned line_number, //
-		const std::string& message
-	);
-};
-
-class parser
+/**
+ * @brief XML parser with virtual event callbacks.
+ * Subclass this class and override the callbacks to handle the parsed data.
+ * For compile-time dispatch of the events use basic_parser directly.
+ */
+class parser : public basic_parser<parser>
 {
-	enum class state {
-		idle,
-		tag,
-		tag_seek_gt,
-		tag_empty,
-		declaration,
-		declaration_end,
-		comment,
-		comment_end,
-		attributes,
-		attribute_name,
-		attribute_seek_to_equals,
-		attribute_seek_to_value,
-		attribute_value,
-		content,
-		ref_char,
-		doctype,
-		doctype_body,
-		doctype_tag,
-		doctype_entity_name,
-		doctype_entity_seek_to_value,
-		doctype_entity_value,
-		doctype_skip_tag,
-		skip_unknown_exclamation_mark_construct,
-		cdata,
-		cdata_terminator
-	} cur_state = state::idle;
-
-	void parse_idle(utki::span<const char>::iterator& i, utki::span<const char>::iterator& e);
-	void parse_tag(utki::span<const char>::iterator& i, utki::span<const char>::iterator& e);
-	void parse_tag_empty(utki::span<const char>::iterator& i, utki::span<const char>::iterator& e);
-	void parse_tag_seek_gt(utki::span<const char>::iterator& i, utki::span<const char>::iterator& e);
-	void parse_declaration(utki::span<const char>::iterator& i, utki::span<const char>::iterator& e);
-	void parse_declaration_end(utki::span<const char>::iterator& i, utki::span<const char>::iterator& e);
-	void parse_comment(utki::span<const char>::iterator& i, utki::span<const char>::iterator& e);
-	void parse_comment_end(utki::span<const char>::iterator& i, utki::span<const char>::iterator& e);
-	void parse_attributes(utki::span<const char>::iterator& i, utki::span<const char>::iterator& e);
-	void parse_attribute_name(utki::span<const char>::iterator& i, utki::span<const char>::iterator& e);
-	void parse_attribute_seek_to_equals(utki::span<const char>::iterator& i, utki::span<const char>::iterator& e);
-	void parse_attribute_seek_to_value(utki::span<const char>::iterator& i, utki::span<const char>::iterator& e);
-	void parse_attribute_value(utki::span<const char>::iterator& i, utki::span<const char>::iterator& e);
-	void parse_content(utki::span<const char>::iterator& i, utki::span<const char>::iterator& e);
-	void parse_ref_char(utki::span<const char>::iterator& i, utki::span<const char>::iterator& e);
-	void parse_doctype(utki::span<const char>::iterator& i, utki::span<const char>::iterator& e);
-	void parse_doctype_body(utki::span<const char>::iterator& i, utki::span<const char>::iterator& e);
-	void parse_doctype_tag(utki::span<const char>::iterator& i, utki::span<const char>::iterator& e);
-	void parse_doctype_skip_tag(utki::span<const char>::iterator& i, utki::span<const char>::iterator& e);
-	void parse_doctype_entity_name(utki::span<const char>::iterator& i, utki::span<const char>::iterator& e);
-	void parse_doctype_entity_seek_to_value(utki::span<const char>::iterator& i, utki::span<const char>::iterator& e);
-	void parse_doctype_entity_value(utki::span<const char>::iterator& i, utki::span<const char>::iterator& e);
-	void parse_skip_unknown_exclamation_mark_construct(
-		utki::span<const char>::iterator& i,
-		utki::span<const char>::iterator& e
-	);
-	void parse_cdata(utki::span<const char>::iterator& i, utki::span<const char>::iterator& e);
-	void parse_cdata_terminator(utki::span<const char>::iterator& i, utki::span<const char>::iterator& e);
-
-	void handle_attribute_parsed();
-
-	void process_parsed_tag_name();
-
-	void process_parsed_ref_char();
-
-	std::vector<char> buf;
-
-	// general variable for storing name of something
-	// (attribute name, entity name, etc.)
-	std::vector<char> name;
-
-	std::vector<char> ref_char_buf;
-
-	char attr_value_quote_char = 0;
-
-	state state_after_ref_char = state::idle;
-
-	unsigned line_number = 1;
-
-	std::map<std::string, std::vector<char>> doctype_entities;
-
 public:
-	parser();
+	explicit parser(const parser_options& options = {}) :
+		basic_parser<parser>(options)
+	{}
 
 	parser(const parser&) = delete;
 	parser& operator=(const parser&) = delete;
 
-	parser(parser&&) = delete;
-	parser& operator=(parser&&) = delete;
+	parser(parser&&) = default;
+	parser& operator=(parser&&) = default;
 
 	/**
 	 * @brief Element start.
@@ -170,32 +86,24 @@ public:
 	virtual void on_content_parsed(utki::span<const char> str) = 0;
 
 	/**
-	 * @brief feed UTF-8 data to parser.
-	 * @param data - data to be fed to parser.
-	 */
-	void feed(utki::span<const char> data);
-
-	/**
-	 * @brief feed UTF-8 data to parser.
-	 * @param data - data to be fed to parser.
+	 * @brief Content chunk parsed notification.
+	 * Called instead of 'on_content_parsed' in content streaming mode,
+	 * see parser_options::stream_content. By default, each non-empty
+	 * chunk is reported by 'on_content_parsed'.
+	 * @param chunk - next part of the content.
+	 * @param is_last - true if the content has ended.
 	 */
-	void feed(utki::span<const uint8_t> data)
+	virtual void on_content_chunk(utki::span<const char> chunk, bool is_last)
 	{
-		this->feed(to_char(data));
+		if (!chunk.empty()) {
+			this->on_content_parsed(chunk);
+		}
 	}
 
-	/**
-	 * @brief Parse in string.
-	 * @param str - string to parse.
-	 */
-	void feed(const std::string& str);
-
-	/**
-	 * @brief Finalize parsing after all data has been fed.
-	 */
-	void end();
-
 	virtual ~parser() noexcept = default;
 };
 
+// the parser is compiled as part of the library
+extern template class basic_parser<parser>;
+
 } // namespace mikroxml
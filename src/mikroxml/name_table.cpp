@@ -0,0 +1,115 @@
+/*
+MIT License
+
+Copyright (c) 2017-2026 Ivan Gagis
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* ================ LICENSE END ================ */
+
+#include "name_table.hpp"
+
+#include <algorithm>
+
+using namespace mikroxml;
+
+namespace {
+constexpr size_t min_num_slots = 0x10;
+} // namespace
+
+uint32_t name_table::hash(std::string_view name) noexcept
+{
+	// FNV-1a
+	// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers)
+	uint32_t h = 2166136261u;
+	for (char c : name) {
+		h ^= uint8_t(c);
+		h *= 16777619u;
+	}
+	// NOLINTEND(cppcoreguidelines-avoid-magic-numbers)
+	return h;
+}
+
+name_table::name_table(std::initializer_list<std::string_view> names)
+{
+	for (const auto& n : names) {
+		this->add(n);
+	}
+}
+
+void name_table::insert(unsigned id)
+{
+	auto h = hash(this->names[id]);
+	size_t mask = this->slots.size() - 1;
+	for (size_t i = h & mask;; i = (i + 1) & mask) {
+		if (this->slots[i].id == unknown) {
+			this->slots[i] = {h, id};
+			return;
+		}
+	}
+}
+
+void name_table::rehash(size_t num_slots)
+{
+	this->slots.assign(num_slots, {0, unknown});
+
+	for (unsigned id = 0; id != this->names.size(); ++id) {
+		this->insert(id);
+	}
+}
+
+unsigned name_table::add(std::string_view name)
+{
+	auto id = this->find(name);
+	if (id != unknown) {
+		return id;
+	}
+
+	id = unsigned(this->names.size());
+	this->names.emplace_back(name);
+
+	// keep the load factor at most 1/2 for short probe sequences
+	if (this->slots.size() < this->names.size() * 2) {
+		this->rehash(std::max(min_num_slots, this->slots.size() * 2));
+	} else {
+		this->insert(id);
+	}
+
+	return id;
+}
+
+unsigned name_table::find(std::string_view name) const noexcept
+{
+	if (this->slots.empty()) {
+		return unknown;
+	}
+
+	auto h = hash(name);
+	size_t mask = this->slots.size() - 1;
+	for (size_t i = h & mask;; i = (i + 1) & mask) {
+		const auto& s = this->slots[i];
+		if (s.id == unknown) {
+			return unknown;
+		}
+		if (s.hash == h && this->names[s.id] == name) {
+			return s.id;
+		}
+	}
+}
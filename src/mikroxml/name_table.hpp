@@ -0,0 +1,114 @@
+/*
+MIT License
+
+Copyright (c) 2017-2026 Ivan Gagis
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* ================ LICENSE END ================ */
+
+#pragma once
+
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace mikroxml {
+
+/**
+ * @brief Table of known element and attribute names.
+ * Maps names to small integer symbol ids, so that the parsed names can be
+ * dispatched with a switch on integer instead of string comparisons.
+ * The ids are assigned sequentially starting from 0 in the order the names are added.
+ * The table is intended to be filled once at startup and then shared by any number of parsers,
+ * see parser_options::names and parser_base::name_id().
+ */
+class name_table
+{
+	std::vector<std::string> names;
+
+	struct slot {
+		uint32_t hash;
+		unsigned id;
+	};
+
+	// open addressing hash table, size is a power of two
+	std::vector<slot> slots;
+
+	static uint32_t hash(std::string_view name) noexcept;
+
+	void insert(unsigned id);
+	void rehash(size_t num_slots);
+
+public:
+	/**
+	 * @brief Id of a name which is not in the table.
+	 */
+	constexpr static unsigned unknown = ~unsigned(0);
+
+	name_table() = default;
+
+	/**
+	 * @brief Construct the table from the list of names.
+	 * The names are added in the list order same way as by add(), so the ids are assigned
+	 * sequentially from 0 in the order of the first occurrence of each name, duplicates are skipped,
+	 * e.g. for {"a", "b", "a", "c"} the ids are a: 0, b: 1, c: 2.
+	 * @param names - the names.
+	 */
+	name_table(std::initializer_list<std::string_view> names);
+
+	/**
+	 * @brief Add name to the table.
+	 * Must not be called while the table is used by some parser.
+	 * @param name - the name to add.
+	 * @return Id of the name. If the name is already in the table, the existing id is returned.
+	 */
+	unsigned add(std::string_view name);
+
+	/**
+	 * @brief Find name id.
+	 * @param name - the name to look for.
+	 * @return Id of the name, or unknown if there is no such name in the table.
+	 */
+	unsigned find(std::string_view name) const noexcept;
+
+	/**
+	 * @brief Get name by id.
+	 * @param id - id of the name.
+	 * @return The name.
+	 */
+	std::string_view name(unsigned id) const noexcept
+	{
+		return this->names[id];
+	}
+
+	/**
+	 * @brief Get number of names in the table.
+	 * @return Number of names.
+	 */
+	size_t size() const noexcept
+	{
+		return this->names.size();
+	}
+};
+
+} // namespace mikroxml
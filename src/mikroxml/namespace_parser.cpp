@@ -0,0 +1,245 @@
+/*
+MIT License
+
+Copyright (c) 2017-2026 Ivan Gagis
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* ================ LICENSE END ================ */
+
+#include "namespace_parser.hpp"
+
+#include <cstring>
+#include <functional>
+#include <string>
+
+using namespace mikroxml;
+
+// the parser is compiled as part of the library
+template class mikroxml::basic_parser<mikroxml::basic_namespace_parser<mikroxml::namespace_parser>>;
+
+namespace {
+constexpr std::string_view xml_namespace_name = "http://www.w3.org/XML/1998/namespace";
+constexpr std::string_view xmlns_namespace_name = "http://www.w3.org/2000/xmlns/";
+
+constexpr std::string_view xml_prefix = "xml";
+constexpr std::string_view xmlns_prefix = "xmlns";
+
+std::string_view to_string_view(utki::span<const char> str) noexcept
+{
+	return {str.data(), str.size()};
+}
+
+// returns size of the prefix, the name which does not have a non-empty prefix
+// and a non-empty local name is unprefixed, the prefix size of the unprefixed name is zero
+size_t prefix_size(utki::span<const char> qualified_name) noexcept
+{
+	if (qualified_name.empty()) {
+		return 0;
+	}
+
+	auto colon = static_cast<const char*>(std::memchr(qualified_name.data(), ':', qualified_name.size()));
+	if (!colon) {
+		return 0;
+	}
+
+	auto ret = size_t(colon - qualified_name.data());
+	if (ret + 1 == qualified_name.size()) {
+		return 0;
+	}
+	return ret;
+}
+
+utki::span<const char> local_name(utki::span<const char> qualified_name) noexcept
+{
+	auto size = prefix_size(qualified_name);
+	return size == 0 ? qualified_name : qualified_name.subspan(size + 1);
+}
+} // namespace
+
+namespace_resolver::namespace_resolver() :
+	namespaces({std::string_view(), xml_namespace_name, xmlns_namespace_name})
+{
+	ASSERT(this->namespaces.find(std::string_view()) == no_namespace)
+	ASSERT(this->namespaces.find(xml_namespace_name) == xml_namespace)
+	ASSERT(this->namespaces.find(xmlns_namespace_name) == xmlns_namespace)
+}
+
+namespace_resolver::token namespace_resolver::store(utki::span<const char> str)
+{
+	std::less_equal<const char*> less_equal;
+	// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+	if (less_equal(this->stable_input.data(), str.data()) &&
+		// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+		less_equal(str.data() + str.size(), this->stable_input.data() + this->stable_input.size()))
+	{
+		return {str.data(), 0, str.size()};
+	}
+
+	token ret = {nullptr, this->tag_chars.size(), str.size()};
+	this->tag_chars.insert(std::end(this->tag_chars), str.begin(), str.end());
+	return ret;
+}
+
+utki::span<const char> namespace_resolver::get(const token& t) const noexcept
+{
+	if (t.stable_data) {
+		return utki::make_span(t.stable_data, t.size);
+	}
+	// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+	return utki::make_span(this->tag_chars.data() + t.offset, t.size);
+}
+
+namespace_resolver::qualified_name namespace_resolver::store_name(utki::span<const char> name)
+{
+	return {this->store(name), prefix_size(name)};
+}
+
+void namespace_resolver::declare(utki::span<const char> prefix, utki::span<const char> namespace_name)
+{
+	if (to_string_view(prefix) == xmlns_prefix) {
+		throw parser_base::syntax_error("the xmlns prefix cannot be declared");
+	}
+
+	unsigned id = namespace_name.empty() ? no_namespace : this->namespaces.add(to_string_view(namespace_name));
+
+	if (!prefix.empty() && id == no_namespace) {
+		throw parser_base::syntax_error("namespace prefix cannot be undeclared");
+	}
+
+	if ((to_string_view(prefix) == xml_prefix) != (id == xml_namespace) || id == xmlns_namespace) {
+		throw parser_base::syntax_error(
+			std::string("reserved namespace cannot be bound to prefix: ").append(to_string_view(prefix))
+		);
+	}
+
+	this->bindings.push_back({this->prefixes.size(), prefix.size(), id});
+	this->prefixes.insert(std::end(this->prefixes), prefix.begin(), prefix.end());
+}
+
+unsigned namespace_resolver::lookup(utki::span<const char> prefix) const
+{
+	// the innermost declaration wins
+	for (auto i = this->bindings.rbegin(); i != this->bindings.rend(); ++i) {
+		// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+		if (std::string_view(this->prefixes.data() + i->prefix_offset, i->prefix_size) == to_string_view(prefix)) {
+			return i->namespace_id;
+		}
+	}
+
+	if (prefix.empty()) {
+		return no_namespace;
+	}
+
+	if (to_string_view(prefix) == xml_prefix) {
+		return xml_namespace;
+	}
+
+	throw parser_base::syntax_error(std::string("undeclared namespace prefix: ").append(to_string_view(prefix)));
+}
+
+void namespace_resolver::start_element(utki::span<const char> name)
+{
+	this->tag_chars.clear();
+	this->buffered_attributes.clear();
+	this->resolved_attributes.clear();
+
+	this->element_name = this->store_name(name);
+
+	this->scopes.push_back({this->bindings.size(), this->prefixes.size(), no_namespace});
+}
+
+void namespace_resolver::add_attribute(utki::span<const char> name, utki::span<const char> value)
+{
+	auto qname = this->store_name(name);
+	this->buffered_attributes.push_back({qname, this->store(value)});
+
+	if (qname.prefix_size == xmlns_prefix.size() || (qname.prefix_size == 0 && name.size() == xmlns_prefix.size())) {
+		if (to_string_view(name.subspan(0, xmlns_prefix.size())) == xmlns_prefix) {
+			auto prefix = qname.prefix_size == 0 ? utki::span<const char>() : name.subspan(xmlns_prefix.size() + 1);
+			this->declare(prefix, value);
+		}
+	}
+}
+
+std::pair<unsigned, utki::span<const char>> namespace_resolver::resolve_start_tag()
+{
+	ASSERT(!this->scopes.empty())
+
+	auto element = this->get(this->element_name.name);
+	auto element_prefix_size = this->element_name.prefix_size;
+
+	// unprefixed element is in the default namespace
+	unsigned element_namespace = this->lookup(element.subspan(0, element_prefix_size));
+	this->scopes.back().namespace_id = element_namespace;
+
+	for (const auto& a : this->buffered_attributes) {
+		auto name = this->get(a.name.name);
+		auto value = this->get(a.value);
+
+		if (a.name.prefix_size == 0) {
+			if (to_string_view(name) == xmlns_prefix) {
+				this->resolved_attributes.push_back({xmlns_namespace, name, value});
+			} else {
+				// unprefixed attribute is in no namespace
+				this->resolved_attributes.push_back({no_namespace, name, value});
+			}
+			continue;
+		}
+
+		auto prefix = name.subspan(0, a.name.prefix_size);
+		auto local = name.subspan(a.name.prefix_size + 1);
+		if (to_string_view(prefix) == xmlns_prefix) {
+			this->resolved_attributes.push_back({xmlns_namespace, local, value});
+		} else {
+			this->resolved_attributes.push_back({this->lookup(prefix), local, value});
+		}
+	}
+
+	return {element_namespace, element_prefix_size == 0 ? element : element.subspan(element_prefix_size + 1)};
+}
+
+std::pair<unsigned, utki::span<const char>> namespace_resolver::end_element(utki::span<const char> name) noexcept
+{
+	// the parser reports unmatched end tags at the top level
+	if (this->scopes.empty()) {
+		return {no_namespace, local_name(name)};
+	}
+
+	const auto& s = this->scopes.back();
+	unsigned id = s.namespace_id;
+	this->bindings.resize(s.num_bindings);
+	this->prefixes.resize(s.prefixes_size);
+	this->scopes.pop_back();
+
+	return {id, local_name(name)};
+}
+
+void namespace_resolver::reset() noexcept
+{
+	this->prefixes.clear();
+	this->bindings.clear();
+	this->scopes.clear();
+	this->stable_input = utki::span<const char>();
+	this->tag_chars.clear();
+	this->element_name = {};
+	this->buffered_attributes.clear();
+	this->resolved_attributes.clear();
+}
@@ -0,0 +1,409 @@
+/*
+MIT License
+
+Copyright (c) 2017-2026 Ivan Gagis
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* ================ LICENSE END ================ */
+
+#pragma once
+
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <utki/span.hpp>
+
+#include "mikroxml.hpp"
+#include "name_table.hpp"
+
+namespace mikroxml {
+
+/**
+ * @brief Resolver of namespace prefixes.
+ * Keeps track of the namespace declarations in scope and resolves qualified names
+ * to pairs of namespace id and local name, see basic_namespace_parser.
+ * Namespace names (URIs) are interned into small integer ids, the ids stay the same
+ * for the whole lifetime of the resolver, also after reset().
+ * The declared prefixes are kept in a flat stack which is unwound as the elements end.
+ * Not intended to be used directly, see basic_namespace_parser.
+ */
+class namespace_resolver
+{
+public:
+	/**
+	 * @brief Id of the empty namespace.
+	 * Unprefixed attributes and unprefixed elements outside of any default namespace declaration
+	 * are in no namespace.
+	 */
+	constexpr static unsigned no_namespace = 0;
+
+	/**
+	 * @brief Id of the "http://www.w3.org/XML/1998/namespace" namespace bound to the "xml" prefix.
+	 */
+	constexpr static unsigned xml_namespace = 1;
+
+	/**
+	 * @brief Id of the "http://www.w3.org/2000/xmlns/" namespace of the namespace declaration attributes.
+	 */
+	constexpr static unsigned xmlns_namespace = 2;
+
+	/**
+	 * @brief Attribute with resolved namespace.
+	 */
+	struct attribute {
+		unsigned namespace_id;
+		utki::span<const char> local_name;
+		utki::span<const char> value;
+	};
+
+private:
+	name_table namespaces;
+
+	struct binding {
+		// prefix is stored in the prefixes array, empty prefix binds the default namespace
+		size_t prefix_offset;
+		size_t prefix_size;
+		unsigned namespace_id;
+	};
+
+	std::vector<char> prefixes;
+	std::vector<binding> bindings;
+
+	struct scope {
+		// bindings and prefixes size before the element's declarations
+		size_t num_bindings;
+		size_t prefixes_size;
+
+		// namespace of the element, reported again on the element end
+		unsigned namespace_id;
+	};
+
+	// one scope per open element
+	std::vector<scope> scopes;
+
+	// the tokens lying within the stable input are referred to directly, the rest is copied
+	utki::span<const char> stable_input;
+
+	// the start tag is buffered until all its attributes, i.e. namespace declarations, are known
+	std::vector<char> tag_chars;
+
+	// token of the buffered start tag
+	struct token {
+		// nullptr if the token is copied to tag_chars
+		const char* stable_data;
+		size_t offset;
+		size_t size;
+	};
+
+	// qualified name split to prefix and local name
+	struct qualified_name {
+		token name;
+
+		// zero if the name is unprefixed
+		size_t prefix_size;
+	};
+
+	struct buffered_attribute {
+		qualified_name name;
+		token value;
+	};
+
+	qualified_name element_name{};
+	std::vector<buffered_attribute> buffered_attributes;
+
+	std::vector<attribute> resolved_attributes;
+
+	token store(utki::span<const char> str);
+	utki::span<const char> get(const token& t) const noexcept;
+
+	qualified_name store_name(utki::span<const char> name);
+
+	void declare(utki::span<const char> prefix, utki::span<const char> namespace_name);
+
+	// returns namespace id bound to the prefix
+	unsigned lookup(utki::span<const char> prefix) const;
+
+public:
+	namespace_resolver();
+
+	/**
+	 * @brief Set the input which stays valid while the start tags are resolved.
+	 * The names and values lying within the stable input are not copied when buffered.
+	 * @param input - the input data, e.g. the document passed to parse_document(),
+	 *        or empty span to copy all the buffered tokens.
+	 */
+	void set_stable_input(utki::span<const char> input) noexcept
+	{
+		this->stable_input = input;
+	}
+
+	/**
+	 * @brief Buffer element start.
+	 * @param name - qualified name of the element.
+	 */
+	void start_element(utki::span<const char> name);
+
+	/**
+	 * @brief Buffer attribute of the started element.
+	 * The "xmlns" and "xmlns:*" attributes declare namespaces.
+	 * Invalid declarations are reported by the parser as malformed_xml.
+	 * @param name - qualified name of the attribute.
+	 * @param value - attribute value.
+	 */
+	void add_attribute(utki::span<const char> name, utki::span<const char> value);
+
+	/**
+	 * @brief Resolve the buffered start tag.
+	 * Enters the element's scope.
+	 * The returned spans point into the resolver's buffer or into the stable input
+	 * and are valid until the next start_element() call.
+	 * Undeclared prefixes are reported by the parser as malformed_xml.
+	 * @return Namespace id and local name of the element.
+	 */
+	std::pair<unsigned, utki::span<const char>> resolve_start_tag();
+
+	/**
+	 * @brief Get resolved attributes of the start tag.
+	 * @return The attributes in document order, including the namespace declarations,
+	 *         which are in xmlns_namespace. Valid until the next start_element() call.
+	 */
+	utki::span<const attribute> attributes() const noexcept
+	{
+		return utki::make_span(this->resolved_attributes);
+	}
+
+	/**
+	 * @brief Leave the element's scope.
+	 * @param name - qualified name of the ended element, or empty span if empty element has ended.
+	 * @return Namespace id of the ended element and the local part of the name.
+	 */
+	std::pair<unsigned, utki::span<const char>> end_element(utki::span<const char> name) noexcept;
+
+	/**
+	 * @brief Intern namespace name.
+	 * Can be used before parsing to get the ids of the known namespaces, e.g. to dispatch
+	 * the parsed names with switch. Any namespace encountered during parsing is added automatically.
+	 * @param namespace_name - the namespace name (URI).
+	 * @return Id of the namespace.
+	 */
+	unsigned add_namespace(std::string_view namespace_name)
+	{
+		return this->namespaces.add(namespace_name);
+	}
+
+	/**
+	 * @brief Get namespace name by id.
+	 * @param id - namespace id.
+	 * @return The namespace name (URI), empty for no_namespace.
+	 */
+	std::string_view namespace_name(unsigned id) const noexcept
+	{
+		return this->namespaces.name(id);
+	}
+
+	/**
+	 * @brief Forget the scopes and the buffered start tag.
+	 * The interned namespace ids are kept.
+	 */
+	void reset() noexcept;
+};
+
+/**
+ * @brief Namespace-aware XML parser with compile-time dispatch of events.
+ * Resolves the prefixes of element and attribute names according to the namespace declarations
+ * and reports namespace ids along with the local names. The start tag events are delayed
+ * until the whole start tag is parsed, since the namespace declarations can follow the names they apply to.
+ * The handler_type must derive from basic_namespace_parser<handler_type> (CRTP) and
+ * provide the following methods, accessible from basic_namespace_parser:
+ * @code
+ * void on_element_start(unsigned namespace_id, utki::span<const char> local_name);
+ * void on_element_end(unsigned namespace_id, utki::span<const char> local_name);
+ * void on_attributes_end(bool is_empty_element);
+ * void on_attribute_parsed(unsigned namespace_id, utki::span<const char> local_name, utki::span<const char> value);
+ * void on_content_parsed(utki::span<const char> str);
+ * @endcode
+ * The local name reported by on_element_end() is empty if empty element has ended.
+ * The namespace declarations are reported as attributes in namespace_resolver::xmlns_namespace,
+ * with local name "xmlns" for the default namespace and the prefix otherwise.
+ * In content streaming mode the content chunks are reported by on_content_parsed().
+ * The parser_base::name_id() is not valid during the callbacks.
+ * @tparam handler_type - the derived class handling the events.
+ */
+template <typename handler_type>
+class basic_namespace_parser : public basic_parser<basic_namespace_parser<handler_type>>
+{
+	friend class basic_parser<basic_namespace_parser<handler_type>>;
+
+	namespace_resolver resolver;
+
+	handler_type& handler() noexcept
+	{
+		return static_cast<handler_type&>(*this);
+	}
+
+	void on_element_start(utki::span<const char> name)
+	{
+		this->resolver.start_element(name);
+	}
+
+	void on_attribute_parsed(utki::span<const char> name, utki::span<const char> value)
+	{
+		this->resolver.add_attribute(name, value);
+	}
+
+	void on_attributes_end(bool is_empty_element)
+	{
+		auto element = this->resolver.resolve_start_tag();
+		this->handler().on_element_start(element.first, element.second);
+		for (const auto& a : this->resolver.attributes()) {
+			this->handler().on_attribute_parsed(a.namespace_id, a.local_name, a.value);
+		}
+		this->handler().on_attributes_end(is_empty_element);
+	}
+
+	void on_element_end(utki::span<const char> name)
+	{
+		auto element = this->resolver.end_element(name);
+		this->handler().on_element_end(element.first, element.second);
+	}
+
+	void on_content_parsed(utki::span<const char> str)
+	{
+		this->handler().on_content_parsed(str);
+	}
+
+protected:
+	explicit basic_namespace_parser(const parser_options& options = {}) :
+		basic_parser<basic_namespace_parser<handler_type>>(options)
+	{}
+
+public:
+	/**
+	 * @brief Intern namespace name.
+	 * See namespace_resolver::add_namespace().
+	 * @param namespace_name - the namespace name (URI).
+	 * @return Id of the namespace.
+	 */
+	unsigned add_namespace(std::string_view namespace_name)
+	{
+		return this->resolver.add_namespace(namespace_name);
+	}
+
+	/**
+	 * @brief Get namespace name by id.
+	 * @param id - namespace id.
+	 * @return The namespace name (URI), empty for namespace_resolver::no_namespace.
+	 */
+	std::string_view namespace_name(unsigned id) const noexcept
+	{
+		return this->resolver.namespace_name(id);
+	}
+
+	/**
+	 * @brief Parse whole UTF-8 document.
+	 * See basic_parser::parse_document(). The start tags are resolved without copying
+	 * the names and values which point directly into the document.
+	 * @param document - the complete document to parse.
+	 */
+	void parse_document(utki::span<const char> document)
+	{
+		this->resolver.set_stable_input(document);
+		try {
+			this->basic_parser<basic_namespace_parser<handler_type>>::parse_document(document);
+		} catch (...) {
+			this->resolver.set_stable_input(utki::span<const char>());
+			throw;
+		}
+		this->resolver.set_stable_input(utki::span<const char>());
+	}
+
+	using basic_parser<basic_namespace_parser<handler_type>>::parse_document;
+
+	/**
+	 * @brief Reset parser to its initial state.
+	 * See parser_base::reset(). The interned namespace ids are kept.
+	 */
+	void reset() noexcept
+	{
+		this->parser_base::reset();
+		this->resolver.reset();
+	}
+};
+
+/**
+ * @brief Namespace-aware XML parser with virtual event callbacks.
+ * Subclass this class and override the callbacks to handle the parsed data.
+ * See basic_namespace_parser for details.
+ */
+class namespace_parser : public basic_namespace_parser<namespace_parser>
+{
+public:
+	explicit namespace_parser(const parser_options& options = {}) :
+		basic_namespace_parser<namespace_parser>(options)
+	{}
+
+	/**
+	 * @brief Element start.
+	 * @param namespace_id - id of the element's namespace.
+	 * @param local_name - local name of the element.
+	 */
+	virtual void on_element_start(unsigned namespace_id, utki::span<const char> local_name) = 0;
+
+	/**
+	 * @brief Element end.
+	 * @param namespace_id - id of the element's namespace.
+	 * @param local_name - local name of the element, empty if empty element has ended.
+	 */
+	virtual void on_element_end(unsigned namespace_id, utki::span<const char> local_name) = 0;
+
+	/**
+	 * @brief Attributes section end notification.
+	 * @param is_empty_element - indicates whether the element is empty element or not.
+	 */
+	virtual void on_attributes_end(bool is_empty_element) = 0;
+
+	/**
+	 * @brief Attribute parsed notification.
+	 * Called after on_element_start(), once for each attribute.
+	 * @param namespace_id - id of the attribute's namespace.
+	 * @param local_name - local name of the attribute.
+	 * @param value - value of the attribute.
+	 */
+	virtual void on_attribute_parsed(
+		unsigned namespace_id, //
+		utki::span<const char> local_name,
+		utki::span<const char> value
+	) = 0;
+
+	/**
+	 * @brief Content parsed notification.
+	 * @param str - parsed content.
+	 */
+	virtual void on_content_parsed(utki::span<const char> str) = 0;
+
+	virtual ~namespace_parser() noexcept = default;
+};
+
+// the parser is compiled as part of the library
+extern template class basic_parser<basic_namespace_parser<namespace_parser>>;
+
+} // namespace mikroxml
@@ -0,0 +1,394 @@
+/*
+MIT License
+
+Copyright (c) 2017-2026 Ivan Gagis
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* ================ LICENSE END ================ */
+
+#include "parallel.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "event_recorder.hpp"
+
+using namespace mikroxml;
+
+namespace {
+// returns position in the document given the position relative to the 'start' position
+text_position append(const text_position& start, const text_position& relative) noexcept
+{
+	text_position ret;
+	ret.offset = start.offset + relative.offset;
+	ret.line = start.line + relative.line - 1;
+	if (relative.line == 1) {
+		ret.line_offset = start.line_offset;
+	} else {
+		ret.line_offset = start.offset + relative.line_offset;
+	}
+	return ret;
+}
+
+struct chunk {
+	// the chunk data followed by the '<' which starts the next chunk, if any
+	utki::span<const char> data;
+	bool is_last;
+
+	std::unique_ptr<event_recorder> recorder;
+	std::exception_ptr error;
+	bool is_parsed;
+};
+
+class chunk_parser_pool
+{
+	utki::span<const char> document;
+	parser_options options;
+
+	std::mutex mutex;
+
+	// signalled when a chunk is submitted or the pool is stopped
+	std::condition_variable work_cv;
+
+	// signalled when a chunk is parsed
+	std::condition_variable done_cv;
+
+	std::deque<chunk*> queue;
+	bool quit = false;
+
+	// already allocated event buffers of the reported chunks, reused to avoid reallocations
+	std::vector<std::vector<event_recorder::event>> spare_event_buffers;
+
+	std::vector<std::thread> threads;
+
+	void run();
+	void parse(chunk& c);
+
+public:
+	chunk_parser_pool(
+		utki::span<const char> document, //
+		const parser_options& options,
+		unsigned num_threads
+	);
+
+	chunk_parser_pool(const chunk_parser_pool&) = delete;
+	chunk_parser_pool& operator=(const chunk_parser_pool&) = delete;
+
+	chunk_parser_pool(chunk_parser_pool&&) = delete;
+	chunk_parser_pool& operator=(chunk_parser_pool&&) = delete;
+
+	~chunk_parser_pool() noexcept
+	{
+		this->stop();
+	}
+
+	void submit(chunk& c);
+
+	void recycle(std::vector<event_recorder::event>&& events);
+
+	// waits until the chunk is parsed
+	void wait(chunk& c);
+
+	// drops the chunks which are not yet being parsed and joins the threads
+	void stop() noexcept;
+};
+
+chunk_parser_pool::chunk_parser_pool(
+	utki::span<const char> document, //
+	const parser_options& options,
+	unsigned num_threads
+) :
+	document(document),
+	options(options)
+{
+	// the chunks are parsed concurrently, while the handler's memory resource is not required to be thread-safe
+	this->options.memory = nullptr;
+
+	try {
+		for (unsigned i = 0; i != num_threads; ++i) {
+			this->threads.emplace_back([this]() {
+				this->run();
+			});
+		}
+	} catch (...) {
+		this->stop();
+		throw;
+	}
+}
+
+void chunk_parser_pool::run()
+{
+	for (;;) {
+		chunk* c = nullptr;
+		{
+			std::unique_lock<std::mutex> lock(this->mutex);
+			this->work_cv.wait(lock, [this]() {
+				return this->quit || !this->queue.empty();
+			});
+			if (this->quit) {
+				return;
+			}
+			c = this->queue.front();
+			this->queue.pop_front();
+		}
+		this->parse(*c);
+	}
+}
+
+void chunk_parser_pool::parse(chunk& c)
+{
+	std::vector<event_recorder::event> events;
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		if (!this->spare_event_buffers.empty()) {
+			events = std::move(this->spare_event_buffers.back());
+			this->spare_event_buffers.pop_back();
+		}
+	}
+
+	std::unique_ptr<event_recorder> recorder;
+	std::exception_ptr error;
+	try {
+		recorder = std::make_unique<event_recorder>(this->document, this->options);
+		recorder->events = std::move(events);
+		recorder->feed(c.data);
+		if (c.is_last) {
+			recorder->end();
+		}
+	} catch (...) {
+		error = std::current_exception();
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		c.recorder = std::move(recorder);
+		c.error = std::move(error);
+		c.is_parsed = true;
+	}
+	this->done_cv.notify_all();
+}
+
+void chunk_parser_pool::submit(chunk& c)
+{
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		this->queue.push_back(&c);
+	}
+	this->work_cv.notify_one();
+}
+
+void chunk_parser_pool::recycle(std::vector<event_recorder::event>&& events)
+{
+	events.clear();
+	std::lock_guard<std::mutex> lock(this->mutex);
+	this->spare_event_buffers.push_back(std::move(events));
+}
+
+void chunk_parser_pool::wait(chunk& c)
+{
+	std::unique_lock<std::mutex> lock(this->mutex);
+	this->done_cv.wait(lock, [&c]() {
+		return c.is_parsed;
+	});
+}
+
+void chunk_parser_pool::stop() noexcept
+{
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		this->quit = true;
+		this->queue.clear();
+	}
+	this->work_cv.notify_all();
+
+	for (auto& t : this->threads) {
+		t.join();
+	}
+	this->threads.clear();
+}
+
+// continues parsing with the given recorder, reporting the events after each piece of data
+void parse_sequentially(
+	event_recorder& recorder, //
+	parser& handler,
+	const char* p,
+	const char* end,
+	size_t piece_size
+)
+{
+	auto parse = [&recorder, &handler](const auto& step) {
+		try {
+			step();
+		} catch (...) {
+			// report the events preceding the error
+			recorder.replay(handler);
+			throw;
+		}
+		recorder.replay(handler);
+		recorder.clear();
+	};
+
+	while (p != end) {
+		auto size = std::min(piece_size, size_t(end - p));
+		parse([&]() {
+			recorder.feed(utki::make_span(p, size));
+		});
+		// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+		p += size;
+	}
+
+	parse([&recorder]() {
+		recorder.end();
+	});
+}
+} // namespace
+
+void mikroxml::parse_document_parallel(
+	parser& handler, //
+	utki::span<const char> document,
+	const parallel_options& options
+)
+{
+	unsigned num_threads = options.num_threads != 0 ? options.num_threads : std::thread::hardware_concurrency();
+	size_t chunk_size = std::max(options.chunk_size, size_t(1));
+
+	// the chunk parsers parse UTF-8 only
+	decoder input_decoder;
+	if (handler.get_options().detect_encoding) {
+		document = input_decoder.decode(document, true);
+	}
+
+	// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+	const char* document_end = document.data() + document.size();
+
+	if (num_threads <= 1 || document.size() <= chunk_size) {
+		// parse with a new parser same as the chunks, so that the handler's own parsing state is not used
+		event_recorder recorder(document, handler.get_options());
+		parse_sequentially(recorder, handler, document.data(), document_end, chunk_size);
+		return;
+	}
+
+	// start of the not yet submitted part of the document
+	const char* split = document.data();
+
+	// the pool is declared after the chunks, so that it is stopped before the chunks are destroyed
+	std::deque<chunk> chunks;
+	chunk_parser_pool pool(document, handler.get_options(), num_threads);
+
+	// limit number of chunks in flight to limit memory used by the recorded events
+	const size_t max_chunks_in_flight = size_t(num_threads) * 2;
+
+	auto submit_chunks = [&]() {
+		// NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+		while (split != document_end && chunks.size() < max_chunks_in_flight) {
+			const char* next_split = document_end;
+			if (size_t(document_end - split) > chunk_size) {
+				auto lt = static_cast<const char*>(
+					std::memchr(split + chunk_size, '<', size_t(document_end - split) - chunk_size)
+				);
+				if (lt) {
+					next_split = lt;
+				}
+			}
+
+			bool is_last = next_split == document_end;
+
+			// non-last chunk also includes the '<' starting the next chunk, so that the
+			// content preceding it gets reported and the parser ends up at tag start
+			auto size = size_t(next_split - split) + (is_last ? 0 : 1);
+
+			chunks.push_back(chunk{utki::make_span(split, size), is_last, nullptr, nullptr, false});
+			pool.submit(chunks.back());
+			split = next_split;
+		}
+		// NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+	};
+
+	// parser of the last reported chunk
+	std::unique_ptr<event_recorder> prev;
+
+	// position of the beginning of the last reported chunk
+	text_position prev_start;
+
+	// element nesting depth at the end of the last reported chunk
+	unsigned depth = 0;
+
+	const unsigned max_depth = handler.get_options().limits.max_depth;
+
+	// checks that the chunk's elements nesting does not exceed the limit and does not go below zero,
+	// the chunk parser does not know the actual depth, so it cannot check it by itself
+	auto is_depth_valid = [&depth, max_depth](const event_recorder::depth_range& range) {
+		return range.min >= -int64_t(depth) && int64_t(depth) + range.max <= int64_t(max_depth);
+	};
+
+	for (submit_chunks(); !chunks.empty(); submit_chunks()) {
+		auto& c = chunks.front();
+		pool.wait(c);
+
+		if (!prev) {
+			// the first chunk is parsed from the document beginning, so it is parsed right for sure
+			if (c.error) {
+				if (c.recorder) {
+					c.recorder->replay(handler);
+				}
+				std::rethrow_exception(c.error);
+			}
+		} else if (c.error || !prev->is_at_tag_start() || prev->has_doctype_entities() ||
+				   !is_depth_valid(c.recorder->get_recorded_depth()))
+		{
+			// the chunk was parsed from wrong parser state, or the error has to be reported
+			// with the right line number, so continue sequentially with the previous chunk's
+			// parser, which has already parsed the '<' starting the chunk
+			pool.stop();
+
+			prev->set_position(append(prev_start, prev->get_position()));
+			prev->set_depth(depth);
+			// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+			parse_sequentially(*prev, handler, c.data.data() + 1, document_end, chunk_size);
+			return;
+		} else {
+			// the chunk starts at the '<' which ends the previous chunk
+			prev_start = append(prev_start, prev->get_position());
+			--prev_start.offset;
+		}
+
+		if (prev) {
+			depth = unsigned(int64_t(depth) + c.recorder->get_recorded_depth().end);
+		} else {
+			// the first chunk is parsed from the document beginning, so its parser knows the actual depth
+			depth = c.recorder->get_depth();
+		}
+
+		c.recorder->replay(handler);
+		pool.recycle(std::move(c.recorder->events));
+		c.recorder->clear();
+
+		prev = std::move(c.recorder);
+		chunks.pop_front();
+	}
+}
@@ -0,0 +1,77 @@
+/*
+MIT License
+
+Copyright (c) 2017-2026 Ivan Gagis
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* ================ LICENSE END ================ */
+
+#pragma once
+
+#include "mikroxml.hpp"
+
+namespace mikroxml {
+
+/**
+ * @brief Parallel parsing options.
+ */
+struct parallel_options {
+	/**
+	 * @brief Number of parsing threads.
+	 * Zero means the number of hardware threads.
+	 */
+	unsigned num_threads = 0;
+
+	/**
+	 * @brief Approximate size of a document chunk parsed by a single thread at a time.
+	 */
+	size_t chunk_size = size_t(1) << 20; // 1 MiB
+};
+
+/**
+ * @brief Parse complete in-memory XML document using several threads.
+ * The document is speculatively split into chunks at '<' characters. The chunks are
+ * parsed in parallel by a pool of threads and the parsed events are reported to the handler
+ * in document order from the calling thread, i.e. the handler sees exactly the same
+ * sequence of events as if the document was parsed with handler.parse_document().
+ * If a split turns out to be inside of a comment, CDATA section, attribute value etc.,
+ * or if the document declares DOCTYPE entities, then the rest of the document after
+ * the invalid split is parsed sequentially.
+ * The handler's own parsing state is not used, it only receives the events, also when
+ * the document is not split because it is not longer than the chunk size or there is a single thread.
+ * If the handler's parser_options::detect_encoding is set, the document in other than UTF-8 encoding
+ * is transcoded as a whole before splitting.
+ * The chunk parsers allocate from the default memory resource, not from the handler's parser_options::memory,
+ * unless the document is parsed by a single parser in the calling thread.
+ * The spans passed to the callbacks are only valid during the callback call.
+ * @param handler - the parser to report the events to. Its options are used for parsing.
+ * @param document - the document to parse.
+ * @param options - parallel parsing options.
+ * @throw malformed_xml - in case of malformed XML document. All the events
+ *        preceding the malformed part are reported before throwing.
+ */
+void parse_document_parallel(
+	parser& handler, //
+	utki::span<const char> document,
+	const parallel_options& options = {}
+);
+
+} // namespace mikroxml
@@ -0,0 +1,310 @@
+/*
+MIT License
+
+Copyright (c) 2017-2026 Ivan Gagis
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* ================ LICENSE END ================ */
+
+#include "path_filter.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+using namespace mikroxml;
+
+path_filter::expression path_filter::compile(std::string_view expression)
+{
+	using namespace std::string_literals;
+
+	if (expression.empty() || expression.front() != '/') {
+		throw std::invalid_argument("path_filter: expression must start with '/': "s.append(expression));
+	}
+
+	path_filter::expression ret;
+
+	for (size_t i = 0; i != expression.size();) {
+		ASSERT(expression[i] == '/')
+		++i;
+
+		bool is_descendant = false;
+		if (i != expression.size() && expression[i] == '/') {
+			is_descendant = true;
+			++i;
+		}
+
+		auto step_end = std::min(expression.find('/', i), expression.size());
+		auto token = expression.substr(i, step_end - i);
+		i = step_end;
+
+		if (token.empty()) {
+			throw std::invalid_argument("path_filter: empty step in expression: "s.append(expression));
+		}
+
+		if (token.front() == '@') {
+			if (i != expression.size()) {
+				throw std::invalid_argument("path_filter: attribute must be the last step: "s.append(expression));
+			}
+			token.remove_prefix(1);
+			if (token.empty()) {
+				throw std::invalid_argument("path_filter: empty attribute name in expression: "s.append(expression));
+			}
+			ret.selects_attribute = true;
+			ret.is_attribute_descendant = is_descendant;
+			ret.attribute.name = token;
+			break;
+		}
+
+		ret.steps.push_back({is_descendant, {std::string(token)}});
+	}
+
+	if (ret.steps.empty() && !ret.is_attribute_descendant) {
+		throw std::invalid_argument("path_filter: expression does not select any element: "s.append(expression));
+	}
+
+	return ret;
+}
+
+path_filter::path_filter(utki::span<const std::string_view> expressions)
+{
+	for (const auto& e : expressions) {
+		this->expressions.push_back(compile(e));
+	}
+}
+
+class path_filter::matcher : public basic_parser<path_filter::matcher>
+{
+	friend class basic_parser<matcher>;
+
+	// state of matching an expression: the expression's steps before the 'step' have been matched,
+	// the step past the last one is the descendant attribute step
+	struct state {
+		size_t expression;
+		size_t step;
+
+		bool operator==(const state& s) const noexcept
+		{
+			return this->expression == s.expression && this->step == s.step;
+		}
+	};
+
+	struct level {
+		// states reached by the element
+		size_t states_begin;
+
+		// expressions matched by the element
+		size_t element_matches_begin;
+	};
+
+	const std::vector<expression>& expressions;
+	const std::function<void(const match&)>& on_match;
+
+	// states of all the open elements, grouped by levels
+	std::vector<state> states;
+
+	// expressions matched by the open elements, grouped by levels,
+	// the content of these elements is reported
+	std::vector<size_t> element_matches;
+
+	// expressions whose attributes are selected from the current element
+	std::vector<size_t> attribute_matches;
+
+	std::vector<level> levels;
+
+	// number of open elements of the subtree which can not produce any matches,
+	// the events are ignored while it is not zero
+	unsigned skip_depth = 0;
+
+	// checks if the current element and its subtree can not produce any more matches
+	bool is_dead_end() const noexcept;
+
+	void pop_level();
+
+	void on_element_start(utki::span<const char> name);
+	void on_element_end(utki::span<const char> name);
+	void on_attributes_end(bool is_empty_element);
+	void on_attribute_parsed(utki::span<const char> name, utki::span<const char> value);
+	void on_content_parsed(utki::span<const char> str);
+
+public:
+	matcher(
+		const std::vector<expression>& expressions, //
+		const std::function<void(const match&)>& on_match,
+		const parser_options& options
+	);
+};
+
+namespace {
+// adds the value if it is not among the vector's elements starting from 'begin', returns true if added
+template <typename value_type>
+bool push_unique(std::vector<value_type>& v, size_t begin, const value_type& value)
+{
+	if (std::find(std::next(v.begin(), std::ptrdiff_t(begin)), v.end(), value) != v.end()) {
+		return false;
+	}
+	v.push_back(value);
+	return true;
+}
+} // namespace
+
+path_filter::matcher::matcher(
+	const std::vector<expression>& expressions, //
+	const std::function<void(const match&)>& on_match,
+	const parser_options& options
+) :
+	basic_parser<matcher>(options),
+	expressions(expressions),
+	on_match(on_match)
+{
+	// the document level
+	for (size_t i = 0; i != this->expressions.size(); ++i) {
+		this->states.push_back({i, 0});
+	}
+	this->levels.push_back({0, 0});
+}
+
+bool path_filter::matcher::is_dead_end() const noexcept
+{
+	const auto& l = this->levels.back();
+	return l.states_begin == this->states.size() && l.element_matches_begin == this->element_matches.size() &&
+		this->attribute_matches.empty();
+}
+
+void path_filter::matcher::pop_level()
+{
+	const auto& l = this->levels.back();
+	this->states.resize(l.states_begin);
+	this->element_matches.resize(l.element_matches_begin);
+	this->levels.pop_back();
+}
+
+void path_filter::matcher::on_element_start(utki::span<const char> name)
+{
+	if (this->skip_depth != 0) {
+		++this->skip_depth;
+		return;
+	}
+
+	auto parent_states_begin = this->levels.back().states_begin;
+	auto parent_states_end = this->states.size();
+	this->levels.push_back({this->states.size(), this->element_matches.size()});
+	this->attribute_matches.clear();
+
+	const auto& l = this->levels.back();
+
+	for (auto i = parent_states_begin; i != parent_states_end; ++i) {
+		auto s = this->states[i];
+		const auto& expr = this->expressions[s.expression];
+
+		if (s.step == expr.steps.size()) {
+			// descendant attribute step matches every element of the subtree
+			push_unique(this->states, l.states_begin, s);
+			push_unique(this->attribute_matches, 0, s.expression);
+			continue;
+		}
+
+		const auto& st = expr.steps[s.step];
+
+		if (st.is_descendant) {
+			// the step can also match deeper
+			push_unique(this->states, l.states_begin, s);
+		}
+
+		if (!st.test.matches(name)) {
+			continue;
+		}
+
+		if (s.step + 1 != expr.steps.size()) {
+			push_unique(this->states, l.states_begin, state{s.expression, s.step + 1});
+		} else if (expr.selects_attribute) {
+			push_unique(this->attribute_matches, 0, s.expression);
+			if (expr.is_attribute_descendant) {
+				push_unique(this->states, l.states_begin, state{s.expression, s.step + 1});
+			}
+		} else if (push_unique(this->element_matches, l.element_matches_begin, s.expression)) {
+			this->on_match({match_type::element, s.expression, name, {}});
+		}
+	}
+
+	if (this->is_dead_end()) {
+		this->pop_level();
+		this->skip_depth = 1;
+	}
+}
+
+void path_filter::matcher::on_element_end(utki::span<const char> name)
+{
+	if (this->skip_depth != 0) {
+		--this->skip_depth;
+		return;
+	}
+
+	if (this->levels.size() > 1) {
+		this->pop_level();
+	}
+}
+
+void path_filter::matcher::on_attributes_end(bool is_empty_element)
+{
+	if (this->skip_depth != 0 || this->attribute_matches.empty()) {
+		return;
+	}
+
+	this->attribute_matches.clear();
+	if (this->is_dead_end()) {
+		this->pop_level();
+		this->skip_depth = 1;
+	}
+}
+
+void path_filter::matcher::on_attribute_parsed(utki::span<const char> name, utki::span<const char> value)
+{
+	if (this->skip_depth != 0) {
+		return;
+	}
+
+	for (auto expr : this->attribute_matches) {
+		if (this->expressions[expr].attribute.matches(name)) {
+			this->on_match({match_type::attribute, expr, name, value});
+		}
+	}
+}
+
+void path_filter::matcher::on_content_parsed(utki::span<const char> str)
+{
+	if (this->skip_depth != 0) {
+		return;
+	}
+
+	for (auto i = this->levels.back().element_matches_begin; i != this->element_matches.size(); ++i) {
+		this->on_match({match_type::content, this->element_matches[i], {}, str});
+	}
+}
+
+void path_filter::filter(
+	utki::span<const char> document, //
+	const std::function<void(const match&)>& on_match,
+	const parser_options& options
+) const
+{
+	matcher m(this->expressions, on_match, options);
+	m.parse_document(document);
+}
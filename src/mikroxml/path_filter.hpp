@@ -0,0 +1,147 @@
+/*
+MIT License
+
+Copyright (c) 2017-2026 Ivan Gagis
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* ================ LICENSE END ================ */
+
+#pragma once
+
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "basic_parser.hpp"
+
+namespace mikroxml {
+
+/**
+ * @brief Filter selecting nodes of the document by simple path expressions.
+ * Supported expressions are absolute location paths consisting of:
+ * - child steps, e.g. /feed/entry/id;
+ * - descendant steps, e.g. //entry or /feed//link;
+ * - the '*' wildcard in place of an element or attribute name;
+ * - attribute selection as the last step, e.g. /feed/entry/link/@href, or as a descendant step,
+ *   e.g. //@id or /feed//@id, which selects the attributes of the context element and all its descendants.
+ *
+ * The expressions are compiled into a set of states which are tracked for each open element.
+ * The document is parsed by parse_document(), the events within elements which can not lead
+ * to any match are ignored without matching.
+ * The filter itself holds no parsing state, so it can be used to filter any number of documents.
+ */
+class path_filter
+{
+public:
+	enum class match_type {
+		/**
+		 * @brief Element matched.
+		 * The match's name holds the element name. Reported when the element starts.
+		 */
+		element,
+
+		/**
+		 * @brief Content of the matched element.
+		 * The match's value holds a piece of the element's content, not including the content
+		 * of its child elements. Reported for each content piece of the matched element.
+		 */
+		content,
+
+		/**
+		 * @brief Attribute matched.
+		 * The match's name and value hold the attribute name and value.
+		 */
+		attribute
+	};
+
+	/**
+	 * @brief Matched node.
+	 * The spans are only valid during the callback call.
+	 */
+	struct match {
+		match_type type;
+
+		/**
+		 * @brief Index of the matched expression.
+		 */
+		size_t expression;
+
+		utki::span<const char> name;
+		utki::span<const char> value;
+	};
+
+private:
+	struct name_test {
+		// "*" matches any name
+		std::string name;
+
+		bool matches(utki::span<const char> n) const noexcept
+		{
+			return this->name == "*" || std::string_view(n.data(), n.size()) == this->name;
+		}
+	};
+
+	struct step {
+		bool is_descendant;
+		name_test test;
+	};
+
+	struct expression {
+		std::vector<step> steps;
+		bool selects_attribute = false;
+
+		// the attributes of the element matching the last step and of all its descendants are selected
+		bool is_attribute_descendant = false;
+
+		name_test attribute;
+	};
+
+	std::vector<expression> expressions;
+
+	class matcher;
+
+	static expression compile(std::string_view expression);
+
+public:
+	/**
+	 * @brief Constructor.
+	 * @param expressions - path expressions to match, the index of each expression
+	 *        in the list is reported with its matches.
+	 * @throw std::invalid_argument - in case of a malformed expression.
+	 */
+	explicit path_filter(utki::span<const std::string_view> expressions);
+
+	/**
+	 * @brief Filter document.
+	 * @param document - the document to filter.
+	 * @param on_match - callback called for each match in document order.
+	 * @param options - parser options.
+	 * @throw malformed_xml - in case of malformed XML document.
+	 */
+	void filter(
+		utki::span<const char> document, //
+		const std::function<void(const match&)>& on_match,
+		const parser_options& options = {}
+	) const;
+};
+
+} // namespace mikroxml
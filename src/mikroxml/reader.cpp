@@ -0,0 +1,257 @@
+/*
+MIT License
+
+Copyright (c) 2017-2026 Ivan Gagis
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* ================ LICENSE END ================ */
+
+#include "reader.hpp"
+
+#include <cstring>
+
+using namespace mikroxml;
+
+reader::reader(utki::span<const char> document, const parser_options& options) :
+	recorder(document, options),
+	pos(document.data()),
+	// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+	document_end(document.data() + document.size())
+{}
+
+reader::event reader::pop_event()
+{
+	ASSERT(this->cur_event < this->recorder.events.size())
+	const auto& e = this->recorder.events[this->cur_event];
+	++this->cur_event;
+
+	event ret;
+	switch (e.type) {
+		case event_recorder::event_type::element_start:
+			ret.type = event_type::start;
+			++this->cur_depth;
+			break;
+		case event_recorder::event_type::element_end:
+			ret.type = event_type::end;
+			if (this->cur_depth != 0) {
+				--this->cur_depth;
+			}
+			break;
+		case event_recorder::event_type::attributes_end:
+			ret.type = event_type::attrs_end;
+			break;
+		case event_recorder::event_type::attribute_parsed:
+			ret.type = event_type::attr;
+			break;
+		case event_recorder::event_type::content_parsed:
+			ret.type = event_type::content;
+			break;
+	}
+
+	ret.name = e.name;
+	ret.value = e.value;
+	ret.is_empty_element = e.is_empty_element;
+	ret.name_id = e.name_id;
+
+	return ret;
+}
+
+bool reader::parse_next()
+{
+	if (this->is_end_reached) {
+		return false;
+	}
+
+	this->recorder.clear();
+	this->cur_event = 0;
+
+	try {
+		if (this->pos == this->document_end) {
+			this->recorder.end();
+			this->is_end_reached = true;
+			return true;
+		}
+
+		// feed the data up to and including the next '>', so that at most one tag gets completed
+		// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+		auto gt = static_cast<const char*>(std::memchr(this->pos, '>', size_t(this->document_end - this->pos)));
+		// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+		const char* chunk_end = gt ? gt + 1 : this->document_end;
+
+		this->recorder.feed(utki::make_span(this->pos, size_t(chunk_end - this->pos)));
+		this->pos = chunk_end;
+	} catch (malformed_xml&) {
+		// the events preceding the error are reported before the error is thrown
+		this->error = std::current_exception();
+		this->is_end_reached = true;
+	}
+
+	return true;
+}
+
+void reader::throw_pending_error()
+{
+	if (this->error) {
+		auto e = this->error;
+		this->error = nullptr;
+		std::rethrow_exception(e);
+	}
+}
+
+reader::event reader::next()
+{
+	while (this->cur_event == this->recorder.events.size()) {
+		this->throw_pending_error();
+		if (!this->parse_next()) {
+			return {};
+		}
+	}
+
+	return this->pop_event();
+}
+
+void reader::skip_subtree()
+{
+	if (this->cur_depth == 0) {
+		throw std::logic_error("reader::skip_subtree(): there is no started element");
+	}
+
+	unsigned target_depth = this->cur_depth - 1;
+
+	for (;;) {
+		// go through the events which have already been parsed
+		while (this->cur_event != this->recorder.events.size()) {
+			this->pop_event();
+			if (this->cur_depth == target_depth) {
+				return;
+			}
+		}
+
+		this->throw_pending_error();
+
+		// the cheap scan can only start outside of any markup
+		if (this->recorder.is_outside_markup()) {
+			break;
+		}
+
+		if (!this->parse_next()) {
+			return;
+		}
+	}
+
+	this->fast_forward(target_depth);
+}
+
+// returns pointer to the last character of the terminator, or end if the terminator is not found
+const char* reader::skip_to_terminator(
+	const char* p, //
+	const char* end,
+	std::string_view terminator
+) noexcept
+{
+	p = parser_base::find(p, end, terminator);
+	if (p == end) {
+		return end;
+	}
+	// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+	return p + terminator.size() - 1;
+}
+
+void reader::fast_forward(unsigned target_depth)
+{
+	using namespace std::string_view_literals;
+
+	const char* skipped_begin = this->pos;
+	const char* p = skipped_begin;
+	const char* end = this->document_end;
+
+	unsigned depth = this->cur_depth;
+
+	// NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+	while (depth != target_depth) {
+		p = parser_base::find(p, end, '<');
+		if (p == end) {
+			break;
+		}
+		++p;
+
+		if (p == end) {
+			break;
+		}
+
+		switch (*p) {
+			case '/':
+				p = parser_base::find(p, end, '>');
+				if (p != end) {
+					--depth;
+				}
+				break;
+			case '?':
+				p = skip_to_terminator(p + 1, end, "?>"sv);
+				break;
+			case '!':
+				if (parser_base::starts_with(p, end, "!--"sv)) {
+					p = skip_to_terminator(p + "!--"sv.size(), end, "-->"sv);
+				} else if (parser_base::starts_with(p, end, "![CDATA["sv)) {
+					p = skip_to_terminator(p + "![CDATA["sv.size(), end, "]]>"sv);
+				} else {
+					p = parser_base::find(p, end, '>');
+				}
+				break;
+			default:
+				// start tag, the attribute values may contain '>'
+				for (;;) {
+					p = parser_base::find_first_of(p, end, '>', '"', '\'');
+					if (p == end || *p == '>') {
+						break;
+					}
+					p = parser_base::find(p + 1, end, *p);
+					if (p == end) {
+						break;
+					}
+					++p;
+				}
+				if (p != end && *(p - 1) != '/') {
+					++depth;
+				}
+				break;
+		}
+
+		if (p == end) {
+			break;
+		}
+
+		// skip the terminating '>'
+		++p;
+	}
+	// NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+
+	this->pos = p;
+
+	// the skipped part ended right after a tag, so the parser continues from idle state
+	this->recorder.skip_to_idle(skipped_begin, p, target_depth);
+
+	// the rest of the document is unterminated markup, there is nothing more to report
+	this->cur_depth = target_depth;
+	if (depth != target_depth) {
+		this->pos = end;
+	}
+}
@@ -0,0 +1,185 @@
+/*
+MIT License
+
+Copyright (c) 2017-2026 Ivan Gagis
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* ================ LICENSE END ================ */
+
+#pragma once
+
+#include <exception>
+#include <vector>
+
+#include "event_recorder.hpp"
+
+namespace mikroxml {
+
+/**
+ * @brief Pull parser.
+ * Parses an in-memory XML document and reports the parsed events one by one
+ * on request, see next(). Uninteresting elements can be skipped with skip_subtree()
+ * without parsing their contents.
+ * The events are produced by the same state machine as the one used by mikroxml::parser.
+ * The document data must remain valid and unchanged during the whole lifetime of the reader.
+ */
+class reader
+{
+public:
+	enum class event_type {
+		/**
+		 * @brief Element start.
+		 * The event's name holds the element name.
+		 */
+		start,
+
+		/**
+		 * @brief Attribute.
+		 * The event's name holds the attribute name and the event's value holds the attribute value.
+		 */
+		attr,
+
+		/**
+		 * @brief Attributes section end.
+		 * The event's is_empty_element indicates whether the element is an empty element.
+		 */
+		attrs_end,
+
+		/**
+		 * @brief Content.
+		 * The event's value holds the content.
+		 */
+		content,
+
+		/**
+		 * @brief Element end.
+		 * The event's name holds the element name. The name is empty if empty element has ended.
+		 */
+		end,
+
+		/**
+		 * @brief End of the document.
+		 * No more events follow.
+		 */
+		end_of_document
+	};
+
+	/**
+	 * @brief Parsed event.
+	 * The spans are valid until the next call to next() or skip_subtree().
+	 */
+	struct event {
+		event_type type = event_type::end_of_document;
+		utki::span<const char> name;
+		utki::span<const char> value;
+		bool is_empty_element = false;
+
+		/**
+		 * @brief Symbol id of the name.
+		 * Id of the element or attribute name in the name table set in parser options,
+		 * see parser_base::name_id().
+		 */
+		unsigned name_id = name_table::unknown;
+	};
+
+	/**
+	 * @brief Constructor.
+	 * @param document - the XML document to read.
+	 * @param options - parser options. The zero_copy option is ignored, the reader
+	 *        always refers to the document data directly when possible.
+	 *        The detect_encoding option is ignored, the document must be UTF-8.
+	 */
+	explicit reader(utki::span<const char> document, const parser_options& options = {});
+
+	reader(const reader&) = delete;
+	reader& operator=(const reader&) = delete;
+
+	reader(reader&&) = delete;
+	reader& operator=(reader&&) = delete;
+
+	~reader() = default;
+
+	/**
+	 * @brief Get next event.
+	 * @return The next parsed event. After the whole document is parsed,
+	 *         the event of type end_of_document is returned.
+	 * @throw malformed_xml - in case of malformed XML document. The events parsed before the error,
+	 *        i.e. the same events as mikroxml::parser reports before throwing, are returned first,
+	 *        the error is thrown by the call which would return the next event.
+	 *        After that, the end_of_document event is returned.
+	 */
+	event next();
+
+	/**
+	 * @brief Skip the rest of the current element.
+	 * Skips all the events up to and including the end event of the most recently
+	 * started element which has not ended yet. The skipped part of the document
+	 * is only scanned for the element nesting, i.e. the skipped elements are not
+	 * checked for well-formedness, and no character references are expanded.
+	 * @throw std::logic_error - if there is no started element.
+	 * @throw malformed_xml - if the document is malformed before the end of the element.
+	 */
+	void skip_subtree();
+
+	/**
+	 * @brief Get current element nesting depth.
+	 * @return Number of elements which have started and have not ended yet.
+	 */
+	unsigned depth() const noexcept
+	{
+		return this->cur_depth;
+	}
+
+private:
+	event_recorder recorder;
+
+	// position of the not yet parsed document data
+	const char* pos;
+
+	const char* document_end;
+
+	// index of the next recorded event to report
+	size_t cur_event = 0;
+
+	unsigned cur_depth = 0;
+
+	bool is_end_reached = false;
+
+	// error thrown after the events preceding it are reported
+	std::exception_ptr error;
+
+	void throw_pending_error();
+
+	event pop_event();
+
+	// parses the next portion of the document, returns false if the whole document has already been parsed
+	bool parse_next();
+
+	static const char* skip_to_terminator(
+		const char* p, //
+		const char* end,
+		std::string_view terminator
+	) noexcept;
+
+	void fast_forward(unsigned target_depth);
+};
+
+} // namespace mikroxml
@@ -0,0 +1,280 @@
+/*
+MIT License
+
+Copyright (c) 2017-2026 Ivan Gagis
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* ================ LICENSE END ================ */
+
+#include "structural_index.hpp"
+
+#include <array>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+#if defined(__SSE2__)
+#	include <emmintrin.h>
+#endif
+
+#include "basic_parser.hpp"
+
+using namespace mikroxml;
+
+namespace {
+// number of characters scanned at once, one bit of a mask per character
+constexpr size_t block_size = 64;
+
+// masks of the characters of interest in a block of the document
+struct block_masks {
+	uint64_t lt;
+	uint64_t gt;
+	uint64_t quote;
+	uint64_t escape;
+};
+
+block_masks scan_block(const char* block) noexcept
+{
+#if defined(__SSE2__)
+	block_masks ret{};
+	for (size_t i = 0; i != block_size; i += sizeof(__m128i)) {
+		// NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast, cppcoreguidelines-pro-bounds-pointer-arithmetic)
+		auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + i));
+
+		auto matches = [&v](char c) {
+			return _mm_cmpeq_epi8(v, _mm_set1_epi8(c));
+		};
+		auto to_mask = [i](__m128i m) {
+			return uint64_t(uint16_t(_mm_movemask_epi8(m))) << i;
+		};
+
+		ret.lt |= to_mask(matches('<'));
+		ret.gt |= to_mask(matches('>'));
+		ret.quote |= to_mask(_mm_or_si128(matches('"'), matches('\'')));
+		ret.escape |= to_mask(_mm_or_si128(matches('&'), matches('\r')));
+	}
+	return ret;
+#else
+	block_masks ret{};
+	for (size_t i = 0; i != block_size; ++i) {
+		auto bit = uint64_t(1) << i;
+		// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+		switch (block[i]) {
+			case '<':
+				ret.lt |= bit;
+				break;
+			case '>':
+				ret.gt |= bit;
+				break;
+			case '"':
+			case '\'':
+				ret.quote |= bit;
+				break;
+			case '&':
+			case '\r':
+				ret.escape |= bit;
+				break;
+			default:
+				break;
+		}
+	}
+	return ret;
+#endif
+}
+
+unsigned count_trailing_zeros(uint64_t mask) noexcept
+{
+#if defined(__GNUC__)
+	return unsigned(__builtin_ctzll(mask));
+#else
+	unsigned ret = 0;
+	for (; (mask & 1) == 0; mask >>= 1) {
+		++ret;
+	}
+	return ret;
+#endif
+}
+} // namespace
+
+structural_index::structural_index(utki::span<const char> document) :
+	data(document)
+{
+	if (document.size() > std::numeric_limits<uint32_t>::max()) {
+		throw std::invalid_argument("structural_index: document is too large");
+	}
+
+	this->build();
+}
+
+// Same as the parser, the quotes are only taken into account within DOCTYPE body.
+// Discrepancies with the parser in malformed markup are detected when the index is used.
+const char* structural_index::find_special_markup_end(const char* p, const char* end) noexcept
+{
+	using namespace std::string_view_literals;
+
+	// NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+	auto find_terminator = [end](const char* p, std::string_view terminator) {
+		p = parser_base::find(p, end, terminator);
+		return p == end ? end : p + terminator.size() - 1;
+	};
+
+	if (*p == '?') {
+		return find_terminator(p + 1, "?>"sv);
+	}
+
+	if (parser_base::starts_with(p, end, parser_base::comment_tag_word)) {
+		return find_terminator(p + parser_base::comment_tag_word.size(), "-->"sv);
+	}
+
+	if (parser_base::starts_with(p, end, parser_base::cdata_tag_word)) {
+		return find_terminator(p + parser_base::cdata_tag_word.size(), "]]>"sv);
+	}
+
+	if (!parser_base::starts_with(p, end, parser_base::doctype_tag_word)) {
+		return parser_base::find(p, end, '>');
+	}
+
+	p += parser_base::doctype_tag_word.size();
+	for (;;) {
+		p = parser_base::find_first_of(p, end, '>', '[', '[');
+		if (p == end || *p == '>') {
+			return p;
+		}
+
+		// DOCTYPE body, entity values may contain ']'
+		for (++p;;) {
+			p = parser_base::find_first_of(p, end, ']', '"', '"');
+			if (p == end) {
+				return end;
+			}
+			if (*p == ']') {
+				++p;
+				break;
+			}
+			p = parser_base::find(p + 1, end, '"');
+			if (p == end) {
+				return end;
+			}
+			++p;
+		}
+	}
+	// NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+}
+
+void structural_index::build()
+{
+	const char* begin = this->data.data();
+	// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+	const char* end = begin + this->data.size();
+
+	enum class state {
+		content,
+		tag,
+		quoted
+	} cur_state = state::content;
+
+	char quote = '\0';
+
+	// offset the scanning continues from after the markup found by scalar search
+	size_t resume_offset = 0;
+
+	// the last incomplete block is copied to the zero-padded buffer
+	std::array<char, block_size> last_block{};
+
+	for (size_t block_offset = 0; block_offset < this->data.size(); block_offset += block_size) {
+		if (resume_offset >= block_offset + block_size) {
+			continue;
+		}
+
+		// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+		const char* block = begin + block_offset;
+		if (this->data.size() - block_offset < block_size) {
+			std::memcpy(last_block.data(), block, this->data.size() - block_offset);
+			block = last_block.data();
+		}
+
+		auto masks = scan_block(block);
+		uint64_t bits = masks.lt | masks.gt | masks.quote | masks.escape;
+		if (resume_offset > block_offset) {
+			bits &= ~uint64_t(0) << (resume_offset - block_offset);
+		}
+
+		while (bits != 0) {
+			auto offset = block_offset + count_trailing_zeros(bits);
+			bits &= bits - 1;
+
+			// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+			const char* p = begin + offset;
+
+			switch (cur_state) {
+				case state::content:
+					if (*p == '<') {
+						this->markup_offsets.push_back(uint32_t(offset));
+
+						// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+						++p;
+						if (p == end || (*p != '!' && *p != '?')) {
+							cur_state = state::tag;
+							break;
+						}
+
+						// comments, CDATA sections etc. are rare and long, so they are searched for directly
+						p = find_special_markup_end(p, end);
+						if (p == end) {
+							// the rest of the document is unterminated markup
+							this->markup_offsets.pop_back();
+							return;
+						}
+						this->markup_offsets.push_back(uint32_t(p - begin));
+
+						resume_offset = size_t(p - begin) + 1;
+						if (resume_offset >= block_offset + block_size) {
+							bits = 0;
+						} else {
+							bits &= ~uint64_t(0) << (resume_offset - block_offset);
+						}
+					} else if (*p == '&' || *p == '\r') {
+						this->escape_offsets.push_back(uint32_t(offset));
+					}
+					break;
+				case state::tag:
+					if (*p == '>') {
+						this->markup_offsets.push_back(uint32_t(offset));
+						cur_state = state::content;
+					} else if (*p == '"' || *p == '\'') {
+						quote = *p;
+						cur_state = state::quoted;
+					}
+					break;
+				case state::quoted:
+					if (*p == quote) {
+						cur_state = state::tag;
+					}
+					break;
+			}
+		}
+	}
+
+	if (cur_state != state::content) {
+		// unterminated tag
+		this->markup_offsets.pop_back();
+	}
+}
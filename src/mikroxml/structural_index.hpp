@@ -0,0 +1,103 @@
+/*
+MIT License
+
+Copyright (c) 2017-2026 Ivan Gagis
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* ================ LICENSE END ================ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <utki/span.hpp>
+
+namespace mikroxml {
+
+/**
+ * @brief Structural index of an XML document.
+ * Holds the offsets of the characters which define the structure of the document,
+ * so that the document can be parsed without scanning its content byte by byte,
+ * see basic_parser::parse_document(const structural_index&).
+ * The index is built in a single vectorized pass over the document. Quotes within tags,
+ * comments, CDATA sections, processing instructions and DOCTYPE are masked out,
+ * i.e. only the '<' and '>' characters which actually start and end markup are indexed.
+ * The index can be used to parse the same document any number of times.
+ * The document data must remain valid and unchanged during the whole lifetime of the index.
+ */
+class structural_index
+{
+	utki::span<const char> data;
+
+	std::vector<uint32_t> markup_offsets;
+
+	std::vector<uint32_t> escape_offsets;
+
+	void build();
+
+	// returns pointer to the '>' terminating the markup which starts with "<!" or "<?",
+	// or end if the markup is unterminated, the p points to the '!' or '?' character
+	static const char* find_special_markup_end(const char* p, const char* end) noexcept;
+
+public:
+	/**
+	 * @brief Constructor.
+	 * Builds the index of the document.
+	 * @param document - the XML document to index.
+	 * @throw std::invalid_argument - if the document is 4 GiB or larger.
+	 */
+	explicit structural_index(utki::span<const char> document);
+
+	/**
+	 * @brief Get indexed document.
+	 * @return The document the index was built for.
+	 */
+	utki::span<const char> document() const noexcept
+	{
+		return this->data;
+	}
+
+	/**
+	 * @brief Get markup boundaries.
+	 * For each markup (tag, comment, CDATA section, etc.) in document order
+	 * the span holds the offset of its starting '<' followed by the offset of its terminating '>'.
+	 * Unterminated markup at the end of the document is not included.
+	 * @return Offsets of the markup boundaries.
+	 */
+	utki::span<const uint32_t> markup() const noexcept
+	{
+		return utki::make_span(this->markup_offsets);
+	}
+
+	/**
+	 * @brief Get content escapes.
+	 * The content between markup which does not contain any of these characters
+	 * is reported as is.
+	 * @return Offsets of the '&' and '\r' characters outside of markup, in document order.
+	 */
+	utki::span<const uint32_t> escapes() const noexcept
+	{
+		return utki::make_span(this->escape_offsets);
+	}
+};
+
+} // namespace mikroxml
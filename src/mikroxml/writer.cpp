@@ -0,0 +1,293 @@
+/*
+MIT License
+
+Copyright (c) 2017-2026 Ivan Gagis
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* ================ LICENSE END ================ */
+
+#include "writer.hpp"
+
+#include <array>
+#include <stdexcept>
+#include <string_view>
+
+#if defined(__SSE2__)
+#	include <emmintrin.h>
+#endif
+
+using namespace mikroxml;
+
+namespace {
+// returns the character reference to write instead of the character, or empty string if the character is not special
+constexpr std::string_view escape(char c, bool is_attribute_value) noexcept
+{
+	using namespace std::string_view_literals;
+
+	switch (c) {
+		case '&':
+			return "&amp;"sv;
+		case '<':
+			return "&lt;"sv;
+		case '>':
+			return "&gt;"sv;
+		case '\r':
+			// the parser drops '\r' characters, so they are escaped to be preserved
+			return "&#xD;"sv;
+		case '"':
+			return is_attribute_value ? "&quot;"sv : ""sv;
+		case '\'':
+			return is_attribute_value ? "&apos;"sv : ""sv;
+		default:
+			return ""sv;
+	}
+}
+
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-magic-numbers)
+constexpr size_t num_chars = 0x100;
+
+// characters which have to be escaped in content and in attribute values
+constexpr std::array<std::array<bool, num_chars>, 2> special_chars = []() {
+	std::array<std::array<bool, num_chars>, 2> ret{};
+	for (size_t i = 0; i != num_chars; ++i) {
+		for (bool is_attribute_value : {false, true}) {
+			ret[size_t(is_attribute_value)][i] = !escape(char(i), is_attribute_value).empty();
+		}
+	}
+	return ret;
+}();
+
+// returns pointer to the first character which has to be escaped, or end if there is no such character
+const char* find_special(const char* p, const char* end, bool is_attribute_value) noexcept
+{
+#if defined(__SSE2__)
+	{
+		constexpr auto block_size = sizeof(__m128i);
+
+		const auto amp = _mm_set1_epi8('&');
+		const auto lt = _mm_set1_epi8('<');
+		const auto gt = _mm_set1_epi8('>');
+		const auto cr = _mm_set1_epi8('\r');
+
+		// the quotes are only searched for in attribute values
+		const auto quot = _mm_set1_epi8(is_attribute_value ? '"' : '&');
+		const auto apos = _mm_set1_epi8(is_attribute_value ? '\'' : '&');
+
+		// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+		for (; size_t(end - p) >= block_size; p += block_size) {
+			// NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+			auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+
+			auto matches = _mm_or_si128(
+				_mm_or_si128(_mm_cmpeq_epi8(block, amp), _mm_cmpeq_epi8(block, lt)),
+				_mm_or_si128(_mm_cmpeq_epi8(block, gt), _mm_cmpeq_epi8(block, cr))
+			);
+			matches = _mm_or_si128(matches, _mm_or_si128(_mm_cmpeq_epi8(block, quot), _mm_cmpeq_epi8(block, apos)));
+
+			auto mask = unsigned(_mm_movemask_epi8(matches));
+			if (mask != 0) {
+				// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+				return p + __builtin_ctz(mask);
+			}
+		}
+	}
+#endif
+
+	const auto& is_special = special_chars[size_t(is_attribute_value)];
+
+	// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+	for (; p != end; ++p) {
+		if (is_special[uint8_t(*p)]) {
+			return p;
+		}
+	}
+	return end;
+}
+} // namespace
+
+writer::writer(const writer_options& options) :
+	options(options)
+{}
+
+writer::writer(sink_type sink, const writer_options& options) :
+	sink(std::move(sink)),
+	options(options)
+{}
+
+void writer::append(utki::span<const char> data)
+{
+	this->buf.insert(std::end(this->buf), data.begin(), data.end());
+}
+
+void writer::append(char c)
+{
+	this->buf.push_back(c);
+}
+
+void writer::append_escaped(utki::span<const char> text, bool is_attribute_value)
+{
+	const char* p = text.data();
+	// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+	const char* end = p + text.size();
+
+	for (;;) {
+		const char* run_end = find_special(p, end, is_attribute_value);
+		this->append(utki::make_span(p, size_t(run_end - p)));
+		if (run_end == end) {
+			return;
+		}
+
+		auto ref = escape(*run_end, is_attribute_value);
+		this->append(utki::make_span(ref.data(), ref.size()));
+
+		// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+		p = run_end + 1;
+	}
+}
+
+void writer::append_new_line(size_t depth)
+{
+	if (this->options.indent.empty()) {
+		return;
+	}
+
+	// no leading new line in the beginning of the document
+	if (this->is_document_started) {
+		this->append('\n');
+	}
+
+	for (size_t i = 0; i != depth; ++i) {
+		this->append(utki::make_span(this->options.indent));
+	}
+}
+
+void writer::close_start_tag()
+{
+	if (this->is_start_tag_open) {
+		this->append('>');
+		this->is_start_tag_open = false;
+	}
+}
+
+void writer::flush_if_needed()
+{
+	if (this->sink && this->buf.size() >= this->options.flush_threshold) {
+		this->flush();
+	}
+}
+
+void writer::flush()
+{
+	if (!this->sink || this->buf.empty()) {
+		return;
+	}
+	this->sink(utki::make_span(this->buf));
+	this->buf.clear();
+}
+
+void writer::declaration()
+{
+	using namespace std::string_view_literals;
+
+	this->append(utki::make_span(R"(<?xml version="1.0" encoding="UTF-8"?>)"sv));
+	this->is_document_started = true;
+	this->flush_if_needed();
+}
+
+void writer::start_element(utki::span<const char> name)
+{
+	this->close_start_tag();
+
+	if (!this->open_elements.empty()) {
+		this->open_elements.back().has_child_elements = true;
+	}
+
+	this->append_new_line(this->open_elements.size());
+
+	this->append('<');
+	this->append(name);
+
+	this->open_elements.push_back({this->names.size()});
+	this->names.insert(std::end(this->names), name.begin(), name.end());
+	this->is_start_tag_open = true;
+	this->is_document_started = true;
+
+	this->flush_if_needed();
+}
+
+void writer::attribute(utki::span<const char> name, utki::span<const char> value)
+{
+	if (!this->is_start_tag_open) {
+		throw std::logic_error("writer::attribute(): there is no open start tag");
+	}
+
+	this->append(' ');
+	this->append(name);
+	this->append('=');
+	this->append('"');
+	this->append_escaped(value, true);
+	this->append('"');
+
+	this->flush_if_needed();
+}
+
+void writer::content(utki::span<const char> text)
+{
+	this->close_start_tag();
+
+	if (!this->open_elements.empty()) {
+		this->open_elements.back().has_content = true;
+	}
+
+	this->append_escaped(text, false);
+	this->is_document_started = true;
+
+	this->flush_if_needed();
+}
+
+void writer::end_element()
+{
+	if (this->open_elements.empty()) {
+		throw std::logic_error("writer::end_element(): there is no open element");
+	}
+
+	const auto& element = this->open_elements.back();
+	auto name = utki::make_span(this->names).subspan(element.name_offset);
+
+	if (this->is_start_tag_open) {
+		this->append('/');
+		this->append('>');
+		this->is_start_tag_open = false;
+	} else {
+		if (element.has_child_elements && !element.has_content) {
+			this->append_new_line(this->open_elements.size() - 1);
+		}
+		this->append('<');
+		this->append('/');
+		this->append(name);
+		this->append('>');
+	}
+
+	this->names.resize(element.name_offset);
+	this->open_elements.pop_back();
+
+	this->flush_if_needed();
+}
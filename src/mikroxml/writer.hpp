@@ -0,0 +1,203 @@
+/*
+MIT License
+
+Copyright (c) 2017-2026 Ivan Gagis
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* ================ LICENSE END ================ */
+
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <utki/span.hpp>
+
+namespace mikroxml {
+
+/**
+ * @brief XML writer options.
+ */
+struct writer_options {
+	/**
+	 * @brief Indentation of one nesting level.
+	 * If not empty, each start tag and each end tag of an element which has child elements
+	 * and no content is written on a new line, indented according to the element's nesting depth.
+	 * Pretty printing is meant for documents without mixed content, since the added
+	 * whitespace is not distinguishable from the content.
+	 */
+	std::string indent;
+
+	/**
+	 * @brief Buffered data size which triggers flushing to the sink.
+	 * Only used when the writer is constructed with a sink.
+	 */
+	size_t flush_threshold = size_t(1) << 16; // 64 KiB
+};
+
+/**
+ * @brief Streaming XML writer.
+ * Serializes XML document piece by piece into an internal buffer.
+ * The buffered data is either retrieved with data(), or passed to the sink
+ * given to the constructor in batches of at least writer_options::flush_threshold bytes.
+ * The writer's methods correspond to the events reported by the parser, so that
+ * the parsed events can be forwarded to the writer directly:
+ * - on_element_start() - start_element();
+ * - on_attribute_parsed() - attribute();
+ * - on_attributes_end() - nothing, the start tag is closed by the following call;
+ * - on_content_parsed() - content();
+ * - on_element_end() - end_element().
+ * The special characters in attribute values and content are replaced with character references,
+ * the runs of ordinary characters are copied as is.
+ */
+class writer
+{
+public:
+	/**
+	 * @brief Data sink.
+	 * Called with the next portion of the written data.
+	 */
+	using sink_type = std::function<void(utki::span<const char> data)>;
+
+private:
+	sink_type sink;
+
+	writer_options options;
+
+	std::vector<char> buf;
+
+	// names of the open elements, one after another
+	std::vector<char> names;
+
+	struct open_element {
+		// offset of the element name in the names buffer
+		size_t name_offset;
+
+		bool has_child_elements = false;
+		bool has_content = false;
+	};
+
+	std::vector<open_element> open_elements;
+
+	// the start tag of the most recently started element is not closed yet, so attributes can be written
+	bool is_start_tag_open = false;
+
+	// for not starting the document with a new line when pretty printing
+	bool is_document_started = false;
+
+	void append(utki::span<const char> data);
+	void append(char c);
+	void append_escaped(utki::span<const char> text, bool is_attribute_value);
+	void append_new_line(size_t depth);
+
+	void close_start_tag();
+	void flush_if_needed();
+
+public:
+	/**
+	 * @brief Constructor.
+	 * The written data is accumulated in the buffer, see data().
+	 * @param options - writer options.
+	 */
+	explicit writer(const writer_options& options = {});
+
+	/**
+	 * @brief Constructor.
+	 * @param sink - sink to pass the written data to.
+	 * @param options - writer options.
+	 */
+	explicit writer(sink_type sink, const writer_options& options = {});
+
+	/**
+	 * @brief Write XML declaration.
+	 * Writes <?xml version="1.0" encoding="UTF-8"?>.
+	 * The declaration must be the first thing written to the document.
+	 */
+	void declaration();
+
+	/**
+	 * @brief Write element start.
+	 * The start tag remains open for the attributes until the next call which is not attribute().
+	 * @param name - element name.
+	 */
+	void start_element(utki::span<const char> name);
+
+	/**
+	 * @brief Write attribute of the most recently started element.
+	 * The value is written in double quotes.
+	 * @param name - attribute name.
+	 * @param value - attribute value, the special characters are escaped.
+	 * @throw std::logic_error - if there is no element whose start tag is open.
+	 */
+	void attribute(utki::span<const char> name, utki::span<const char> value);
+
+	/**
+	 * @brief Write content.
+	 * @param text - the content, the special characters are escaped.
+	 */
+	void content(utki::span<const char> text);
+
+	/**
+	 * @brief Write end of the most recently started element.
+	 * If nothing has been written since the element start, then the element
+	 * is written as an empty element, i.e. the start tag ends with "/>".
+	 * @throw std::logic_error - if there is no open element.
+	 */
+	void end_element();
+
+	/**
+	 * @brief Get current element nesting depth.
+	 * @return Number of elements which have started and have not ended yet.
+	 */
+	size_t depth() const noexcept
+	{
+		return this->open_elements.size();
+	}
+
+	/**
+	 * @brief Pass the buffered data to the sink.
+	 * Does nothing if the writer has no sink.
+	 * Note, that the writer does not flush the data on destruction.
+	 */
+	void flush();
+
+	/**
+	 * @brief Get buffered data.
+	 * @return The written data which has not been passed to the sink yet.
+	 */
+	utki::span<const char> data() const noexcept
+	{
+		return utki::make_span(this->buf);
+	}
+
+	/**
+	 * @brief Discard buffered data.
+	 * The writing state, e.g. the open elements, is kept.
+	 * Capacity of the buffer is preserved.
+	 */
+	void clear() noexcept
+	{
+		this->buf.clear();
+	}
+};
+
+} // namespace mikroxml
@@ -0,0 +1,1063 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory_resource>
+#include <new>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fsif/native_file.hpp>
+
+#include "../../src/mikroxml/batch.hpp"
+#include "../../src/mikroxml/document.hpp"
+#include "../../src/mikroxml/mikroxml.hpp"
+#include "../../src/mikroxml/namespace_parser.hpp"
+#include "../../src/mikroxml/parallel.hpp"
+#include "../../src/mikroxml/path_filter.hpp"
+#include "../../src/mikroxml/writer.hpp"
+
+// count memory allocations to report number of allocations per document
+namespace {
+std::atomic<size_t> num_allocations{0};
+} // namespace
+
+void* operator new(size_t size)
+{
+	++num_allocations;
+	// NOLINTNEXTLINE(cppcoreguidelines-no-malloc)
+	if (void* p = std::malloc(size == 0 ? 1 : size)) {
+		return p;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+	// NOLINTNEXTLINE(cppcoreguidelines-no-malloc)
+	std::free(p);
+}
+
+void operator delete(void* p, size_t size) noexcept
+{
+	// NOLINTNEXTLINE(cppcoreguidelines-no-malloc)
+	std::free(p);
+}
+
+namespace {
+const std::string data_dir = "../unit/samples_data/";
+
+// approximate size of the generated documents
+constexpr size_t synthetic_document_size = size_t(4) << 20; // 4 MiB
+
+// number of measurements for each benchmark, the median is reported
+constexpr unsigned num_samples = 5;
+
+// minimal duration of a single measurement
+constexpr auto min_sample_duration = std::chrono::milliseconds(100);
+
+// number of small messages in the batch parsing benchmark
+constexpr size_t num_messages = 10000;
+} // namespace
+
+namespace {
+class parser : public mikroxml::parser
+{
+public:
+	size_t num_events = 0;
+
+	parser(const mikroxml::parser_options& options) :
+		mikroxml::parser(options)
+	{}
+
+	void on_element_start(utki::span<const char> name) override
+	{
+		++this->num_events;
+	}
+
+	void on_element_end(utki::span<const char> name) override
+	{
+		++this->num_events;
+	}
+
+	void on_attributes_end(bool is_empty_element) override
+	{
+		++this->num_events;
+	}
+
+	void on_attribute_parsed(utki::span<const char> name, utki::span<const char> value) override
+	{
+		++this->num_events;
+	}
+
+	void on_content_parsed(utki::span<const char> str) override
+	{
+		++this->num_events;
+	}
+};
+} // namespace
+
+namespace {
+class static_parser : public mikroxml::basic_parser<static_parser>
+{
+public:
+	size_t num_events = 0;
+
+	void on_element_start(utki::span<const char> name)
+	{
+		++this->num_events;
+	}
+
+	void on_element_end(utki::span<const char> name)
+	{
+		++this->num_events;
+	}
+
+	void on_attributes_end(bool is_empty_element)
+	{
+		++this->num_events;
+	}
+
+	void on_attribute_parsed(utki::span<const char> name, utki::span<const char> value)
+	{
+		++this->num_events;
+	}
+
+	void on_content_parsed(utki::span<const char> str)
+	{
+		++this->num_events;
+	}
+};
+} // namespace
+
+namespace {
+// set of documents which are parsed in one benchmark iteration
+struct input {
+	std::string name;
+	std::vector<std::vector<char>> documents;
+
+	size_t size() const noexcept
+	{
+		size_t ret = 0;
+		for (const auto& d : this->documents) {
+			ret += d.size();
+		}
+		return ret;
+	}
+};
+
+std::vector<char> load(const std::string& file_name)
+{
+	auto data = fsif::native_file(file_name).load();
+	return {data.begin(), data.end()};
+}
+
+input load_samples()
+{
+	input ret;
+
+	const std::regex suffix_regex("^.*\\.xml$");
+	auto files = fsif::native_file(data_dir).list_dir();
+	std::sort(files.begin(), files.end());
+
+	for (const auto& f : files) {
+		if (std::regex_match(f, suffix_regex)) {
+			ret.documents.push_back(load(data_dir + f));
+		}
+	}
+
+	ret.name = "samples_data (" + std::to_string(ret.documents.size()) + " files)";
+	return ret;
+}
+
+// generates a document consisting of repeated records
+template <typename record_generator_type>
+input generate(const std::string& name, record_generator_type record_generator)
+{
+	std::string doc = "<?xml version=\"1.0\"?>\n<root>\n";
+	for (unsigned i = 0; doc.size() < synthetic_document_size; ++i) {
+		record_generator(doc, i);
+	}
+	doc.append("</root>\n");
+
+	return {name, {{doc.begin(), doc.end()}}};
+}
+
+std::vector<input> generate_synthetic()
+{
+	std::vector<input> ret;
+
+	ret.push_back(generate("attribute-heavy", [](std::string& doc, unsigned i) {
+		auto n = std::to_string(i);
+		doc.append("<item id=\"").append(n);
+		doc.append("\" name=\"item number ").append(n);
+		doc.append("\" type='regular' x=\"12.5\" y=\"-3.25\" width=\"100\" height=\"200\" enabled=\"true\"/>\n");
+	}));
+
+	ret.push_back(generate("text-heavy", [](std::string& doc, unsigned i) {
+		doc.append(
+			"<p>Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod tempor "
+			"incididunt ut labore et dolore magna aliqua. Ut enim ad minim veniam, quis nostrud "
+			"exercitation ullamco laboris nisi ut aliquip ex ea commodo consequat. Duis aute irure "
+			"dolor in reprehenderit in voluptate velit esse cillum dolore eu fugiat nulla pariatur.\n"
+			"Excepteur sint occaecat cupidatat non proident, sunt in culpa qui officia deserunt "
+			"mollit anim id est laborum.</p>\n"
+		);
+	}));
+
+	ret.push_back(generate("entity-heavy", [](std::string& doc, unsigned i) {
+		doc.append(
+			"<p title='&quot;quoted&quot; &amp; escaped'>a &lt; b &amp;&amp; c &gt; d, "
+			"&apos;e&apos; &#x41;&#66;&#x43;&#x20AC;&#8364;</p>\n"
+		);
+	}));
+
+	ret.push_back(generate("deeply nested", [](std::string& doc, unsigned i) {
+		constexpr unsigned depth = 1000;
+		for (unsigned j = 0; j != depth; ++j) {
+			doc.append("<node level='").append(std::to_string(j)).append("'>");
+		}
+		doc.append("leaf");
+		for (unsigned j = 0; j != depth; ++j) {
+			doc.append("</node>");
+		}
+		doc.append("\n");
+	}));
+
+	ret.push_back(generate("comment-heavy", [](std::string& doc, unsigned i) {
+		doc.append("<!-- commented out: ");
+		for (unsigned j = 0; j != 8; ++j) {
+			doc.append("<item id='").append(std::to_string(j)).append("'>- payload - text -</item>\n");
+		}
+		doc.append("-->\n<?pi some processing instruction data ?>\n<item/>\n");
+	}));
+
+	ret.push_back(generate("records", [](std::string& doc, unsigned i) {
+		doc.append("<record id='").append(std::to_string(i)).append("'>");
+		doc.append("<name>Record name</name><value type=\"int\">12345</value><flag/>");
+		doc.append("<!-- comment --><![CDATA[cdata <text>]]></record>\n");
+	}));
+
+	return ret;
+}
+} // namespace
+
+namespace {
+enum class mode {
+	feed,
+	feed_zero_copy,
+	parse_document,
+	static_dispatch,
+	parallel,
+	document,
+	structural_index,
+	indexed
+};
+
+struct benchmark {
+	mode m;
+
+	// size of chunks the data is fed by, 0 means whole document at once
+	size_t chunk_size = 0;
+
+	std::string description() const
+	{
+		switch (this->m) {
+			case mode::feed:
+			case mode::feed_zero_copy:
+				{
+					std::string ret = this->m == mode::feed ? "feed" : "feed, zero-copy";
+					if (this->chunk_size == 0) {
+						return ret;
+					}
+					return ret + ", " + std::to_string(this->chunk_size) + " byte chunks";
+				}
+			case mode::parse_document:
+				return "parse_document";
+			case mode::static_dispatch:
+				return "parse_document, basic_parser";
+			case mode::parallel:
+				return "parse_document_parallel";
+			case mode::document:
+				return "document::parse (events = nodes)";
+			case mode::structural_index:
+				return "structural_index (events = markup)";
+			case mode::indexed:
+				return "parse_document, structural_index";
+		}
+		return "";
+	}
+
+	// parses the document, returns number of events
+	size_t parse(const std::vector<char>& data) const
+	{
+		if (this->m == mode::static_dispatch) {
+			static_parser p;
+			p.parse_document(utki::make_span(data));
+			return p.num_events;
+		}
+
+		if (this->m == mode::document) {
+			auto doc = mikroxml::document::parse(utki::make_span(data));
+			return doc.size();
+		}
+
+		if (this->m == mode::structural_index) {
+			mikroxml::structural_index index(utki::make_span(data));
+			return index.markup().size() / 2;
+		}
+
+		mikroxml::parser_options options;
+		options.zero_copy = this->m == mode::feed_zero_copy;
+
+		parser p(options);
+
+		switch (this->m) {
+			case mode::parse_document:
+				p.parse_document(utki::make_span(data));
+				break;
+			case mode::parallel:
+				mikroxml::parse_document_parallel(p, utki::make_span(data));
+				break;
+			case mode::indexed:
+				p.parse_document(mikroxml::structural_index(utki::make_span(data)));
+				break;
+			default:
+				{
+					auto span = utki::make_span(data);
+					size_t chunk_size = this->chunk_size == 0 ? span.size() : this->chunk_size;
+					for (size_t i = 0; i < span.size(); i += chunk_size) {
+						p.feed(span.subspan(i, std::min(chunk_size, span.size() - i)));
+					}
+					p.end();
+				}
+				break;
+		}
+		return p.num_events;
+	}
+
+	// parses all the input documents, returns number of events
+	size_t parse(const input& in) const
+	{
+		size_t num_events = 0;
+		for (const auto& d : in.documents) {
+			num_events += this->parse(d);
+		}
+		return num_events;
+	}
+};
+
+// returns sorted numbers of iterations per second of each sample
+template <typename function_type>
+std::vector<double> measure(function_type iteration)
+{
+	std::vector<double> iterations_per_second;
+
+	for (unsigned i = 0; i != num_samples; ++i) {
+		size_t num_iterations = 0;
+
+		auto start = std::chrono::steady_clock::now();
+		auto elapsed = std::chrono::steady_clock::duration::zero();
+
+		while (elapsed < min_sample_duration) {
+			iteration();
+			++num_iterations;
+			elapsed = std::chrono::steady_clock::now() - start;
+		}
+
+		auto seconds = std::chrono::duration<double>(elapsed).count();
+		iterations_per_second.push_back(double(num_iterations) / seconds);
+	}
+
+	std::sort(iterations_per_second.begin(), iterations_per_second.end());
+	return iterations_per_second;
+}
+
+void run(const input& in, const benchmark& b)
+{
+	// warm up and count events and allocations
+	size_t num_allocations_before = num_allocations;
+	size_t num_events = b.parse(in);
+	size_t num_allocations_per_iteration = num_allocations - num_allocations_before;
+
+	auto bytes_per_second = measure([&]() {
+		b.parse(in);
+	});
+	for (auto& r : bytes_per_second) {
+		r *= double(in.size());
+	}
+	double median = bytes_per_second[bytes_per_second.size() / 2];
+
+	double events_per_second = median * double(num_events) / double(in.size());
+
+	std::cout << std::left << std::setw(32) << in.name << std::setw(40) << b.description() << std::right << std::fixed
+			  << std::setprecision(1) << std::setw(9) << median / 1e6 << " MB/s (min " << bytes_per_second.front() / 1e6 << ", max "
+			  << bytes_per_second.back() / 1e6 << "), " << std::setw(7) << std::setprecision(2) << events_per_second / 1e6
+			  << " Mevents/s, " << std::setw(7) << std::setprecision(1)
+			  << double(num_allocations_per_iteration) / double(in.documents.size()) << " allocs/doc" << std::endl;
+}
+} // namespace
+
+namespace {
+class message_handler : public mikroxml::batch_handler
+{
+public:
+	using mikroxml::batch_handler::batch_handler;
+
+	size_t num_events = 0;
+
+	void on_element_start(utki::span<const char> name) override
+	{
+		++this->num_events;
+	}
+
+	void on_element_end(utki::span<const char> name) override
+	{
+		++this->num_events;
+	}
+
+	void on_attributes_end(bool is_empty_element) override
+	{
+		++this->num_events;
+	}
+
+	void on_attribute_parsed(utki::span<const char> name, utki::span<const char> value) override
+	{
+		++this->num_events;
+	}
+
+	void on_content_parsed(utki::span<const char> str) override
+	{
+		++this->num_events;
+	}
+};
+
+// generates small messages of 0.5 to 1.5 KiB
+std::vector<std::string> generate_messages()
+{
+	std::vector<std::string> ret;
+	for (size_t i = 0; i != num_messages; ++i) {
+		auto n = std::to_string(i);
+		std::string msg = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+		msg.append("<envelope id=\"").append(n).append("\" version=\"2\">\n<header><from>gateway</from>");
+		msg.append("<to>service</to><timestamp>2026-01-01T00:00:00Z</timestamp></header>\n<body>\n");
+		for (size_t j = 0; j != 4 + i % 16; ++j) {
+			msg.append("<entry key=\"key").append(std::to_string(j)).append("\" type='string'>");
+			msg.append("value &amp; more value ").append(n).append("</entry>\n");
+		}
+		msg.append("</body>\n</envelope>\n");
+		ret.push_back(std::move(msg));
+	}
+	return ret;
+}
+
+void print_messages_result(const std::string& description, const std::vector<double>& batches_per_second, size_t size)
+{
+	double median = batches_per_second[batches_per_second.size() / 2];
+
+	std::cout << std::left << std::setw(32) << "small messages" << std::setw(40) << description << std::right
+			  << std::fixed << std::setprecision(1) << std::setw(9) << median * double(num_messages) / 1e3
+			  << " kmsg/s (min " << batches_per_second.front() * double(num_messages) / 1e3 << ", max "
+			  << batches_per_second.back() * double(num_messages) / 1e3 << "), " << std::setw(9)
+			  << median * double(size) / 1e6 << " MB/s" << std::endl;
+}
+
+void run_messages()
+{
+	auto messages = generate_messages();
+
+	std::vector<utki::span<const char>> spans;
+	size_t size = 0;
+	for (const auto& m : messages) {
+		spans.push_back(utki::make_span(m));
+		size += m.size();
+	}
+
+	std::cout << "small messages: " << messages.size() << " document(s), " << size << " bytes" << std::endl;
+
+	// the parser is constructed for each message
+	print_messages_result(
+		"new parser per message",
+		measure([&]() {
+			for (const auto& s : spans) {
+				message_handler p;
+				p.parse_document(s);
+			}
+		}),
+		size
+	);
+
+	// the parser's buffers are allocated from the arena which is dropped after each message
+	std::vector<char> arena_buffer(0x4000); // 16kb
+	print_messages_result(
+		"new parser per message, arena",
+		measure([&]() {
+			for (const auto& s : spans) {
+				std::pmr::monotonic_buffer_resource arena(arena_buffer.data(), arena_buffer.size());
+				mikroxml::parser_options options;
+				options.memory = &arena;
+				message_handler p(options);
+				p.parse_document(s);
+			}
+		}),
+		size
+	);
+
+	std::vector<unsigned> thread_counts;
+	unsigned max_threads = std::max(std::thread::hardware_concurrency(), 1u);
+	for (unsigned n = 1; n < max_threads; n *= 2) {
+		thread_counts.push_back(n);
+	}
+	thread_counts.push_back(max_threads);
+
+	for (auto n : thread_counts) {
+		mikroxml::batch_options options;
+		options.num_threads = n;
+
+		mikroxml::batch_parser parser(
+			[]() {
+				return std::make_unique<message_handler>();
+			},
+			options
+		);
+
+		print_messages_result(
+			"batch_parser, " + std::to_string(n) + " thread(s)",
+			measure([&]() {
+				parser.parse(utki::make_span(spans));
+			}),
+			size
+		);
+	}
+}
+} // namespace
+
+namespace {
+// generates an Atom-like feed with large entries, of which only a few nodes are selected
+std::vector<char> generate_feed()
+{
+	std::string doc = "<?xml version=\"1.0\"?>\n<feed xmlns=\"http://www.w3.org/2005/Atom\">\n<title>Feed</title>\n";
+	for (unsigned i = 0; doc.size() < synthetic_document_size; ++i) {
+		auto n = std::to_string(i);
+		doc.append("<entry>\n<title type=\"text\">Entry ").append(n).append("</title>\n");
+		doc.append("<id>urn:uuid:").append(n).append("</id>\n");
+		doc.append("<link rel=\"alternate\" href=\"http://example.com/entry/").append(n).append("\"/>\n");
+		doc.append("<author><name>Author</name><email>author@example.com</email></author>\n");
+		doc.append("<content type=\"xhtml\"><div>");
+		for (unsigned j = 0; j != 8; ++j) {
+			doc.append("<p class='paragraph'>Lorem ipsum dolor sit amet, <b>consectetur</b> adipiscing elit, ");
+			doc.append("sed do eiusmod tempor incididunt ut labore et dolore magna aliqua &amp; more.</p>");
+		}
+		doc.append("</div></content>\n</entry>\n");
+	}
+	doc.append("</feed>\n");
+	return {doc.begin(), doc.end()};
+}
+
+void run_filter()
+{
+	auto doc = generate_feed();
+
+	std::cout << "feed: 1 document(s), " << doc.size() << " bytes" << std::endl;
+
+	auto print_result = [&doc](const std::string& description, const std::vector<double>& per_second) {
+		double median = per_second[per_second.size() / 2];
+		auto size = double(doc.size());
+		std::cout << std::left << std::setw(32) << "feed" << std::setw(40) << description << std::right << std::fixed
+				  << std::setprecision(1) << std::setw(9) << median * size / 1e6 << " MB/s (min "
+				  << per_second.front() * size / 1e6 << ", max " << per_second.back() * size / 1e6 << ")"
+				  << std::endl;
+	};
+
+	print_result("parse_document, all events", measure([&]() {
+					 parser p({});
+					 p.parse_document(utki::make_span(doc));
+				 }));
+
+	const std::vector<std::string_view> expressions = {"/feed/entry/id", "/feed/entry/link/@href"};
+	mikroxml::path_filter filter(utki::make_span(expressions));
+
+	size_t num_matches = 0;
+	print_result("path_filter, 2 expressions", measure([&]() {
+					 filter.filter(utki::make_span(doc), [&num_matches](const mikroxml::path_filter::match& m) {
+						 ++num_matches;
+					 });
+				 }));
+}
+} // namespace
+
+namespace {
+// re-emits the parsed document with std::stringstream
+class stream_echo : public mikroxml::parser
+{
+	void write_escaped(utki::span<const char> text)
+	{
+		for (auto c : text) {
+			switch (c) {
+				case '&':
+					this->ss << "&amp;";
+					break;
+				case '<':
+					this->ss << "&lt;";
+					break;
+				case '>':
+					this->ss << "&gt;";
+					break;
+				case '"':
+					this->ss << "&quot;";
+					break;
+				default:
+					this->ss << c;
+					break;
+			}
+		}
+	}
+
+public:
+	std::stringstream ss;
+
+	void on_element_start(utki::span<const char> name) override
+	{
+		this->ss << '<' << std::string_view(name.data(), name.size());
+	}
+
+	void on_element_end(utki::span<const char> name) override
+	{
+		if (name.empty()) {
+			return;
+		}
+		this->ss << "</" << std::string_view(name.data(), name.size()) << '>';
+	}
+
+	void on_attributes_end(bool is_empty_element) override
+	{
+		this->ss << (is_empty_element ? "/>" : ">");
+	}
+
+	void on_attribute_parsed(utki::span<const char> name, utki::span<const char> value) override
+	{
+		this->ss << ' ' << std::string_view(name.data(), name.size()) << "=\"";
+		this->write_escaped(value);
+		this->ss << '"';
+	}
+
+	void on_content_parsed(utki::span<const char> str) override
+	{
+		this->write_escaped(str);
+	}
+};
+
+// re-emits the parsed document with mikroxml::writer
+class writer_echo : public mikroxml::parser
+{
+public:
+	mikroxml::writer w;
+
+	writer_echo() = default;
+
+	writer_echo(mikroxml::writer::sink_type sink) :
+		w(std::move(sink))
+	{}
+
+	void on_element_start(utki::span<const char> name) override
+	{
+		this->w.start_element(name);
+	}
+
+	void on_element_end(utki::span<const char> name) override
+	{
+		this->w.end_element();
+	}
+
+	void on_attributes_end(bool is_empty_element) override {}
+
+	void on_attribute_parsed(utki::span<const char> name, utki::span<const char> value) override
+	{
+		this->w.attribute(name, value);
+	}
+
+	void on_content_parsed(utki::span<const char> str) override
+	{
+		this->w.content(str);
+	}
+};
+
+void run_write(const input& in)
+{
+	auto print_result = [&in](const std::string& description, const std::vector<double>& per_second) {
+		double median = per_second[per_second.size() / 2];
+		auto size = double(in.size());
+		std::cout << std::left << std::setw(32) << in.name << std::setw(40) << description << std::right << std::fixed
+				  << std::setprecision(1) << std::setw(9) << median * size / 1e6 << " MB/s (min "
+				  << per_second.front() * size / 1e6 << ", max " << per_second.back() * size / 1e6 << ")"
+				  << std::endl;
+	};
+
+	print_result("parse_document, std::stringstream", measure([&]() {
+					 for (const auto& d : in.documents) {
+						 stream_echo p;
+						 p.parse_document(utki::make_span(d));
+					 }
+				 }));
+
+	print_result("parse_document, writer", measure([&]() {
+					 for (const auto& d : in.documents) {
+						 writer_echo p;
+						 p.parse_document(utki::make_span(d));
+					 }
+				 }));
+
+	size_t written_size = 0;
+	print_result("parse_document, writer with sink", measure([&]() {
+					 for (const auto& d : in.documents) {
+						 writer_echo p([&written_size](utki::span<const char> data) {
+							 written_size += data.size();
+						 });
+						 p.parse_document(utki::make_span(d));
+						 p.w.flush();
+					 }
+				 }));
+}
+} // namespace
+
+namespace {
+// converts UTF-8 document to Latin-1, the characters not representable in Latin-1 are replaced with '?'
+std::vector<char> to_latin1(const std::vector<char>& utf8)
+{
+	std::string ret = "<?xml version=\"1.0\" encoding=\"ISO-8859-1\"?>";
+	for (size_t i = 0; i != utf8.size();) {
+		auto c = uint8_t(utf8[i]);
+		if (c < 0x80) {
+			ret.push_back(char(c));
+			++i;
+		} else if ((c & 0xfe) == 0xc2 && i + 1 != utf8.size()) {
+			// U+0080 to U+00FF
+			ret.push_back(char(((c & 0x1f) << 6) | (uint8_t(utf8[i + 1]) & 0x3f)));
+			i += 2;
+		} else {
+			ret.push_back('?');
+			for (++i; i != utf8.size() && (uint8_t(utf8[i]) & 0xc0) == 0x80; ++i) {
+			}
+		}
+	}
+	return {ret.begin(), ret.end()};
+}
+
+// converts UTF-8 document to UTF-16LE with byte order mark
+std::vector<char> to_utf16le(const std::vector<char>& utf8)
+{
+	std::vector<char> ret = {'\xff', '\xfe'};
+	auto append_unit = [&ret](char32_t unit) {
+		ret.push_back(char(unit & 0xff));
+		ret.push_back(char(unit >> 8));
+	};
+	for (size_t i = 0; i != utf8.size();) {
+		auto c = uint8_t(utf8[i]);
+		size_t length = c < 0x80 ? 1 : c < 0xe0 ? 2 : c < 0xf0 ? 3 : 4;
+		length = std::min(length, utf8.size() - i);
+		char32_t code_point = length == 1 ? c : c & (0xff >> (length + 1));
+		for (size_t j = 1; j != length; ++j) {
+			code_point = (code_point << 6) | (uint8_t(utf8[i + j]) & 0x3f);
+		}
+		if (code_point < 0x10000) {
+			append_unit(code_point);
+		} else {
+			append_unit(0xd800 + ((code_point - 0x10000) >> 10));
+			append_unit(0xdc00 + ((code_point - 0x10000) & 0x3ff));
+		}
+		i += length;
+	}
+	return ret;
+}
+
+void run_decode(const input& utf8_input)
+{
+	std::array<std::pair<std::string, input>, 2> encoded = {
+		{
+			{"Latin-1", {utf8_input.name, {}}},
+			{"UTF-16LE", {utf8_input.name, {}}},
+		}
+	};
+	for (const auto& d : utf8_input.documents) {
+		encoded[0].second.documents.push_back(to_latin1(d));
+		encoded[1].second.documents.push_back(to_utf16le(d));
+	}
+
+	mikroxml::parser_options options;
+	options.detect_encoding = true;
+
+	constexpr size_t chunk_size = 0x10000; // 64 KiB
+
+	for (const auto& e : encoded) {
+		const auto& in = e.second;
+
+		auto print_result = [&e](const std::string& description, const std::vector<double>& per_second) {
+			double median = per_second[per_second.size() / 2];
+			auto size = double(e.second.size());
+			std::cout << std::left << std::setw(32) << e.second.name << std::setw(40) << e.first + ", " + description
+					  << std::right << std::fixed << std::setprecision(1) << std::setw(9) << median * size / 1e6
+					  << " MB/s (min " << per_second.front() * size / 1e6 << ", max "
+					  << per_second.back() * size / 1e6 << ")" << std::endl;
+		};
+
+		// the whole document is transcoded to a separate buffer before parsing
+		print_result("decode, then feed 64 KiB", measure([&]() {
+						 for (const auto& d : in.documents) {
+							 mikroxml::decoder decoder;
+							 auto decoded = decoder.decode(utki::make_span(d), true);
+							 std::vector<char> utf8(decoded.begin(), decoded.end());
+
+							 parser p({});
+							 for (size_t i = 0; i < utf8.size(); i += chunk_size) {
+								 p.feed(utki::make_span(utf8.data() + i, std::min(chunk_size, utf8.size() - i)));
+							 }
+							 p.end();
+						 }
+					 }));
+
+		print_result("feed 64 KiB, detect", measure([&]() {
+						 for (const auto& d : in.documents) {
+							 parser p(options);
+							 for (size_t i = 0; i < d.size(); i += chunk_size) {
+								 p.feed(utki::make_span(d.data() + i, std::min(chunk_size, d.size() - i)));
+							 }
+							 p.end();
+						 }
+					 }));
+
+		print_result("parse_document, detect", measure([&]() {
+						 for (const auto& d : in.documents) {
+							 parser p(options);
+							 p.parse_document(utki::make_span(d));
+						 }
+					 }));
+	}
+}
+} // namespace
+
+namespace {
+// generates SVG-like document with prefixed names
+std::vector<char> generate_svg()
+{
+	std::string doc = "<?xml version=\"1.0\"?>\n<svg xmlns=\"http://www.w3.org/2000/svg\"";
+	doc.append(" xmlns:xlink=\"http://www.w3.org/1999/xlink\"");
+	doc.append(" xmlns:inkscape=\"http://www.inkscape.org/namespaces/inkscape\">\n");
+	for (unsigned i = 0; doc.size() < synthetic_document_size; ++i) {
+		auto n = std::to_string(i);
+		doc.append("<g inkscape:label=\"layer ").append(n).append("\" id=\"g").append(n).append("\">\n");
+		doc.append("<path id=\"p").append(n).append("\" d=\"M 0 0 L 10 10 z\" style=\"fill:none\"/>\n");
+		doc.append("<use xlink:href=\"#p").append(n).append("\" x=\"1\" y=\"2\"/>\n");
+		doc.append("<text xml:space=\"preserve\">Label ").append(n).append("</text>\n</g>\n");
+	}
+	doc.append("</svg>\n");
+	return {doc.begin(), doc.end()};
+}
+
+// resolves namespaces the usual way, with strings and maps
+class map_namespace_parser : public mikroxml::parser
+{
+	std::string element_name;
+	std::vector<std::pair<std::string, std::string>> attributes;
+
+	// stack of namespaces for each prefix
+	std::map<std::string, std::vector<std::string>> bindings;
+
+	// prefixes declared by each open element
+	std::vector<std::vector<std::string>> declared;
+
+	std::string resolve(const std::string& qualified_name, bool is_element)
+	{
+		auto colon = qualified_name.find(':');
+		std::string prefix = colon == std::string::npos ? std::string() : qualified_name.substr(0, colon);
+		if (prefix.empty() && !is_element) {
+			return {};
+		}
+		if (prefix == "xml") {
+			return "http://www.w3.org/XML/1998/namespace";
+		}
+		auto i = this->bindings.find(prefix);
+		if (i == this->bindings.end() || i->second.empty()) {
+			return {};
+		}
+		return i->second.back();
+	}
+
+public:
+	size_t num_events = 0;
+
+	void on_element_start(utki::span<const char> name) override
+	{
+		this->element_name.assign(name.data(), name.size());
+		this->attributes.clear();
+	}
+
+	void on_element_end(utki::span<const char> name) override
+	{
+		++this->num_events;
+		for (const auto& prefix : this->declared.back()) {
+			this->bindings[prefix].pop_back();
+		}
+		this->declared.pop_back();
+	}
+
+	void on_attributes_end(bool is_empty_element) override
+	{
+		this->declared.emplace_back();
+		for (const auto& a : this->attributes) {
+			if (a.first == "xmlns") {
+				this->bindings[std::string()].push_back(a.second);
+				this->declared.back().emplace_back();
+			} else if (a.first.compare(0, 6, "xmlns:") == 0) {
+				auto prefix = a.first.substr(6);
+				this->bindings[prefix].push_back(a.second);
+				this->declared.back().push_back(prefix);
+			}
+		}
+
+		this->num_events += this->resolve(this->element_name, true).size();
+		for (const auto& a : this->attributes) {
+			this->num_events += this->resolve(a.first, false).size();
+		}
+	}
+
+	void on_attribute_parsed(utki::span<const char> name, utki::span<const char> value) override
+	{
+		this->attributes.emplace_back(std::string(name.data(), name.size()), std::string(value.data(), value.size()));
+	}
+
+	void on_content_parsed(utki::span<const char> str) override
+	{
+		++this->num_events;
+	}
+};
+
+class namespace_counter : public mikroxml::namespace_parser
+{
+public:
+	size_t num_events = 0;
+
+	void on_element_start(unsigned namespace_id, utki::span<const char> local_name) override
+	{
+		this->num_events += namespace_id;
+	}
+
+	void on_element_end(unsigned namespace_id, utki::span<const char> local_name) override
+	{
+		++this->num_events;
+	}
+
+	void on_attributes_end(bool is_empty_element) override
+	{
+		++this->num_events;
+	}
+
+	void on_attribute_parsed(
+		unsigned namespace_id, //
+		utki::span<const char> local_name,
+		utki::span<const char> value
+	) override
+	{
+		this->num_events += namespace_id;
+	}
+
+	void on_content_parsed(utki::span<const char> str) override
+	{
+		++this->num_events;
+	}
+};
+
+void run_namespaces()
+{
+	auto doc = generate_svg();
+
+	std::cout << "svg: 1 document(s), " << doc.size() << " bytes" << std::endl;
+
+	auto print_result = [&doc](const std::string& description, const std::vector<double>& per_second) {
+		double median = per_second[per_second.size() / 2];
+		auto size = double(doc.size());
+		std::cout << std::left << std::setw(32) << "svg" << std::setw(40) << description << std::right << std::fixed
+				  << std::setprecision(1) << std::setw(9) << median * size / 1e6 << " MB/s (min "
+				  << per_second.front() * size / 1e6 << ", max " << per_second.back() * size / 1e6 << ")"
+				  << std::endl;
+	};
+
+	print_result("parse_document, qualified names", measure([&]() {
+					 parser p({});
+					 p.parse_document(utki::make_span(doc));
+				 }));
+
+	print_result("parse_document, std::map prefix stack", measure([&]() {
+					 map_namespace_parser p;
+					 p.parse_document(utki::make_span(doc));
+				 }));
+
+	print_result("parse_document, namespace_parser", measure([&]() {
+					 namespace_counter p;
+					 p.parse_document(utki::make_span(doc));
+				 }));
+}
+} // namespace
+
+int main(int argc, const char** argv)
+{
+	std::vector<input> inputs;
+
+	if (argc > 1) {
+		// benchmark only the given sample files
+		// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+		for (auto f : utki::make_span(argv + 1, size_t(argc - 1))) {
+			inputs.push_back({f, {load(data_dir + f)}});
+		}
+	} else {
+		inputs.push_back(load_samples());
+		auto synthetic = generate_synthetic();
+		inputs.insert(inputs.end(), synthetic.begin(), synthetic.end());
+	}
+
+	const std::vector<benchmark> benchmarks = {
+		{mode::feed, 64},
+		{mode::feed, 4096},
+		{mode::feed, 65536},
+		{mode::feed, 0},
+		{mode::feed_zero_copy, 4096},
+		{mode::feed_zero_copy, 0},
+		{mode::parse_document, 0},
+		{mode::static_dispatch, 0},
+		{mode::parallel, 0},
+		{mode::document, 0},
+		{mode::structural_index, 0},
+		{mode::indexed, 0}
+	};
+
+	for (const auto& in : inputs) {
+		std::cout << in.name << ": " << in.documents.size() << " document(s), " << in.size() << " bytes" << std::endl;
+		for (const auto& b : benchmarks) {
+			run(in, b);
+		}
+	}
+
+	if (argc <= 1) {
+		run_messages();
+		run_filter();
+		run_namespaces();
+	}
+
+	std::cout << "parse and write back:" << std::endl;
+	for (const auto& in : inputs) {
+		run_write(in);
+	}
+
+	std::cout << "transcoded input:" << std::endl;
+	for (const auto& in : inputs) {
+		run_decode(in);
+	}
+
+	return 0;
+}
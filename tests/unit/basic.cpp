@@ -1,11 +1,14 @@
 #include <tst/set.hpp>
 #include <tst/check.hpp>
 
+#include <utki/string.hpp>
+
 #include "../../src/mikroxml/mikroxml.hpp"
 
 #include <array>
 #include <sstream>
 #include <fstream>
+#include <tuple>
 
 namespace{
 class parser : public mikroxml::parser{
@@ -40,6 +43,39 @@ public:
 };
 }
 
+namespace{
+class static_parser : public mikroxml::basic_parser<static_parser>{
+public:
+	std::stringstream ss;
+
+	void on_attribute_parsed(utki::span<const char> name, utki::span<const char> value){
+		ss << " " << name << "='" << value << "'";
+	}
+
+	void on_element_end(utki::span<const char> name){
+		if(name.size() == 0){
+			ss << "/>";
+		}else{
+			ss << "</" << name << ">";
+		}
+	}
+
+	void on_attributes_end(bool is_empty_element){
+		if(!is_empty_element){
+			ss << ">";
+		}
+	}
+
+	void on_element_start(utki::span<const char> name){
+		ss << '<' << name;
+	}
+
+	void on_content_parsed(utki::span<const char> str){
+		ss << str;
+	}
+};
+}
+
 namespace{
 // NOLINTNEXTLINE(cppcoreguidelines-interfaces-global-init)
 const tst::set set("basic", [](tst::suite& suite){
@@ -53,7 +89,11 @@ const tst::set set("basic", [](tst::suite& suite){
 				{"<element attribute='attribute&#xbf5;Value'>content&#1050;</element>",
 						"<element attribute='attribute௵Value'>contentК</element>"},
 				{"<element attribute='attribute&#xbf5;Value'/>",
-						"<element attribute='attribute௵Value'/>"}
+						"<element attribute='attribute௵Value'/>"},
+				{"<a b='&#x41;&#65;'>&#x7f;&#x80;&#x7FF;&#x800;&#xFFFF;&#x10000;&#x10FFFF;&#0065;</a>",
+						"<a b='AA'>\x7f\u0080\u07ff\u0800\uffff\U00010000\U0010ffffA</a>"},
+				{"<!DOCTYPE x [ <!ENTITY e \"first\"> <!ENTITY e \"second\"> <!ENTITY amp \"AMP\"> ]><a b='&e;&amp;'>&lt;&e;&quot;&apos;&gt;</a>",
+						"<a b='firstAMP'><first\"'></a>"}
 			},
 			[](const auto& p){
 				parser parser;
@@ -67,6 +107,26 @@ const tst::set set("basic", [](tst::suite& suite){
 			}
 		);
 	
+	suite.add<std::string_view>(
+			"basic_parser_same_as_parser",
+			{
+				"<element attribute=\"attributeValue\">content</element>",
+				"<element attribute='attribute&amp;&lt;&gt;&quot;&apos;Value'>content&amp;&lt;&gt;&quot;&apos;</element>",
+				"<?xml version='1.0'?><!-- comment --><a b='c'><![CDATA[cdata]]><d/></a>"
+			},
+			[](const auto& p){
+				parser parser;
+				parser.feed(p);
+				parser.end();
+
+				static_parser static_parser;
+				static_parser.feed(p);
+				static_parser.end();
+
+				tst::check_eq(static_parser.ss.str(), parser.ss.str(), SL);
+			}
+		);
+
 	suite.add(
 		"read_from_istream",
 		[](){
@@ -94,5 +154,229 @@ const tst::set set("basic", [](tst::suite& suite){
 			tst::check_ne(parser.ss.str().size(), size_t(0), SL);
 		}
 	);
+
+	suite.add(
+		"zero_copy_spans_point_to_input",
+		[](){
+			class zero_copy_parser : public mikroxml::parser{
+			public:
+				utki::span<const char> input;
+				std::vector<std::string> copied;
+
+				zero_copy_parser() :
+						mikroxml::parser([](){
+							mikroxml::parser_options options;
+							options.zero_copy = true;
+							return options;
+						}())
+				{}
+
+				void check_span(utki::span<const char> s){
+					if(s.empty()){
+						return;
+					}
+					if(s.data() < this->input.data() || s.data() + s.size() > this->input.data() + this->input.size()){
+						this->copied.push_back(utki::make_string(s));
+					}
+				}
+
+				void on_attribute_parsed(utki::span<const char> name, utki::span<const char> value) override{
+					this->check_span(name);
+					this->check_span(value);
+				}
+				void on_element_end(utki::span<const char> name) override{
+					this->check_span(name);
+				}
+				void on_attributes_end(bool is_empty_element) override{}
+				void on_element_start(utki::span<const char> name) override{
+					this->check_span(name);
+				}
+				void on_content_parsed(utki::span<const char> str) override{
+					this->check_span(str);
+				}
+			} parser;
+
+			std::string_view chunk1 = "<element attr='value' other_attr='other&amp;value'>some content</element><el";
+			std::string_view chunk2 = "ement attr2='val";
+			std::string_view chunk3 = "ue2' attr3='value3'>content &lt; with ref</element>";
+
+			for(auto chunk : {chunk1, chunk2, chunk3}){
+				parser.input = utki::make_span(chunk);
+				parser.feed(parser.input);
+			}
+			parser.end();
+
+			// only tokens which cross chunk boundaries or contain character references are copied
+			std::vector<std::string> expected = {"other&value", "element", "attr2", "value2", "content < with ref"};
+			tst::check(parser.copied == expected, SL);
+		}
+	);
+
+	suite.add<std::string_view>(
+			"parse_document_same_as_feed",
+			{
+				"<element attribute=\"attributeValue\">content</element>",
+				"<element attribute='attribute&amp;&lt;&gt;&quot;&apos;Value'>content&amp;&lt;&gt;&quot;&apos;</element>",
+				"<element attribute='attribute&#xbf5;Value'>content&#1050;</element>",
+				"\r\n<a\r\n  b = \"1\r\n2\" c='\"'\n/>text\r\nmore<b>&lt;text</b>",
+				"<!-- comment --><!-- --- --> still comment --><a/>",
+				"<!-- - -> -- > ---- ->--><a/>",
+				"<?xml version='1.0'?\?> still declaration ?><a/>",
+				"<![CDATA[ some ]] cdata ]>\n]]>",
+				"<!DOCTYPE x [\n<!ENTITY e \"val\nue\">\n<!ELEMENT br EMPTY>\n]><a b='&e;'>&e;</a>",
+				"<!unknown construct><a/>",
+				"<a b>c='d'/>",
+				"<a></a  >",
+				"<a>unterminated content",
+				"<a b='unterminated value",
+				"<a",
+				"<",
+				"</",
+				"<a/",
+				"<a/b>",
+				"<a =>",
+				"<a b c>",
+				"<a b=c>",
+				"</a b>",
+				"<a>&unknown;</a>",
+				"<a>&#xZZ;</a>",
+				"<!DOCTYPE x [ <!UNKNOWN> ]>",
+				"<!DOCTYPE x [ <> ]>",
+				"<!DOCTYPE x [ <!ENTITY e 'v'> ]>",
+				"<!DOCTYPE x [ <!ENT"
+			},
+			[](const auto& p){
+				enum class mode{
+					parse_document,
+					feed,
+					feed_by_byte
+				};
+
+				auto parse = [&p](mode m){
+					parser parser;
+					try{
+						switch(m){
+							case mode::parse_document:
+								parser.parse_document(utki::make_span(p));
+								break;
+							case mode::feed:
+								parser.feed(p);
+								parser.end();
+								break;
+							case mode::feed_by_byte:
+								for(auto c : p){
+									parser.feed(utki::make_span(&c, 1));
+								}
+								parser.end();
+								break;
+						}
+					}catch(mikroxml::malformed_xml& e){
+						parser.ss << " error: " << e.what();
+					}
+					return parser.ss.str();
+				};
+
+				auto expected = parse(mode::parse_document);
+				tst::check_eq(parse(mode::feed), expected, SL);
+				tst::check_eq(parse(mode::feed_by_byte), expected, SL);
+			}
+		);
+
+	suite.add<std::string_view>(
+			"invalid_numeric_character_reference",
+			{
+				"<a>&#;</a>",
+				"<a>&#x;</a>",
+				"<a>&#X41;</a>",
+				"<a>&#x0;</a>",
+				"<a>&#0;</a>",
+				"<a>&#xD800;</a>",
+				"<a>&#xDFFF;</a>",
+				"<a>&#x110000;</a>",
+				"<a>&#1114112;</a>",
+				"<a>&#xFFFFFFFF41;</a>",
+				"<a>&#99999999999999999999;</a>",
+				"<a>&#12a;</a>",
+				"<a>&#x-1;</a>",
+				"<a>&#+65;</a>",
+				"<a>&# 65;</a>",
+				"<a b='&#xD800;'/>"
+			},
+			[](const auto& p){
+				parser parser;
+
+				try{
+					parser.feed(p);
+					parser.end();
+					tst::check(false, SL) << "exception expected";
+				}catch(mikroxml::malformed_xml& e){
+					std::string what = e.what();
+					tst::check(what.find("numeric character reference") != std::string::npos, SL) << "what = " << what;
+				}
+			}
+		);
+
+	suite.add<std::pair<std::string_view, std::string_view>>(
+			"malformed_xml_line_number",
+			{
+				{"<a>\ncontent\r\nmore content\n<b =", "line: 4"},
+				{"<a attr='line1\nline2\nline3'\n\n=", "line: 5"},
+				{"<a>\n some long enough content to be scanned in blocks,\n\n and some more of it \n</a b>", "line: 5"}
+			},
+			[](const auto& p){
+				parser parser;
+
+				try{
+					parser.feed(p.first);
+					parser.end();
+					tst::check(false, SL) << "exception expected";
+				}catch(mikroxml::malformed_xml& e){
+					std::string what = e.what();
+					tst::check(what.find(p.second) != std::string::npos, SL) << "what = " << what;
+				}
+			}
+		);
+
+	suite.add<std::tuple<std::string_view, unsigned, size_t, size_t>>(
+			"malformed_xml_position",
+			{
+				// document, line, column, offset
+				{"<a>\ncontent\r\nmore content\n<b =", 4, 4, 29},
+				{"<a attr='line1\nline2\nline3'\n\n=", 5, 1, 29},
+				{"<a>\n some long enough content to be scanned in blocks,\n\n and some more of it \n</a b>", 5, 5, 82},
+				{"<a>\n\t<b>&unknown;</b>\n</a>", 2, 13, 16},
+				{"<a>\n<", 2, 2, 5},
+				{"<a\n/", 2, 2, 4}
+			},
+			[](const auto& p){
+				auto doc = std::get<0>(p);
+
+				for(unsigned mode = 0; mode != 3; ++mode){
+					parser parser;
+					try{
+						switch(mode){
+							case 0:
+								parser.feed(utki::make_span(doc));
+								parser.end();
+								break;
+							case 1:
+								for(auto c : doc){
+									parser.feed(utki::make_span(&c, 1));
+								}
+								parser.end();
+								break;
+							default:
+								parser.parse_document(utki::make_span(doc));
+								break;
+						}
+						tst::check(false, SL) << "exception expected, mode = " << mode;
+					}catch(mikroxml::malformed_xml& e){
+						tst::check_eq(e.line(), std::get<1>(p), SL) << "mode = " << mode << ", what = " << e.what();
+						tst::check_eq(e.column(), std::get<2>(p), SL) << "mode = " << mode << ", what = " << e.what();
+						tst::check_eq(e.offset(), std::get<3>(p), SL) << "mode = " << mode << ", what = " << e.what();
+					}
+				}
+			}
+		);
 });
 }
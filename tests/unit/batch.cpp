@@ -0,0 +1,186 @@
+#include <tst/set.hpp>
+#include <tst/check.hpp>
+
+#include <utki/string.hpp>
+
+#include "../../src/mikroxml/batch.hpp"
+
+#include <sstream>
+
+namespace{
+// prints each document into its own slot of the results
+class handler : public mikroxml::batch_handler{
+	std::stringstream ss;
+
+public:
+	std::vector<std::string>& results;
+
+	handler(std::vector<std::string>& results) :
+		results(results)
+	{}
+
+	void on_document_start(size_t index) override{
+		this->ss.str(std::string());
+	}
+
+	void on_document_end(size_t index) override{
+		this->results[index] = this->ss.str();
+	}
+
+	void on_attribute_parsed(utki::span<const char> name, utki::span<const char> value) override{
+		if(std::string_view(value.data(), value.size()) == "throw"){
+			throw std::runtime_error("handler error");
+		}
+		ss << " " << name << "='" << value << "'";
+	}
+
+	void on_element_end(utki::span<const char> name) override{
+		if(name.size() == 0){
+			ss << "/>";
+		}else{
+			ss << "</" << name << ">";
+		}
+	}
+
+	void on_attributes_end(bool is_empty_element) override{
+		if(!is_empty_element){
+			ss << ">";
+		}
+	}
+
+	void on_element_start(utki::span<const char> name) override{
+		ss << '<' << name;
+	}
+
+	void on_content_parsed(utki::span<const char> str) override{
+		ss << str;
+	}
+};
+
+std::vector<std::string> make_documents(size_t num){
+	std::vector<std::string> ret;
+	for(size_t i = 0; i != num; ++i){
+		auto n = std::to_string(i);
+		ret.push_back("<!DOCTYPE m [<!ENTITY n \"" + n + "\">]><m id='&n;'><v>" + n + "</v><e/></m>");
+	}
+	return ret;
+}
+
+std::string expected_result(size_t i){
+	auto n = std::to_string(i);
+	return "<m id='" + n + "'><v>" + n + "</v><e/></m>";
+}
+}
+
+namespace{
+// NOLINTNEXTLINE(cppcoreguidelines-interfaces-global-init)
+const tst::set set("batch", [](tst::suite& suite){
+	suite.add<unsigned>(
+		"parse_batch",
+		{1, 2, 3, 8},
+		[](const auto& num_threads){
+			constexpr size_t num_documents = 1000;
+			auto docs = make_documents(num_documents);
+
+			std::vector<utki::span<const char>> spans;
+			for(const auto& d : docs){
+				spans.push_back(utki::make_span(d));
+			}
+
+			std::vector<std::string> results(num_documents);
+			unsigned num_handlers = 0;
+
+			mikroxml::batch_options options;
+			options.num_threads = num_threads;
+
+			mikroxml::batch_parser parser(
+				[&](){
+					++num_handlers;
+					return std::make_unique<handler>(results);
+				},
+				options
+			);
+			tst::check_eq(parser.num_threads(), size_t(num_threads), SL);
+
+			// the threads and the handlers are reused by the subsequent batches
+			for(unsigned batch = 0; batch != 3; ++batch){
+				std::fill(results.begin(), results.end(), std::string());
+
+				auto errors = parser.parse(utki::make_span(spans));
+				tst::check_eq(errors.size(), num_documents, SL);
+
+				for(size_t i = 0; i != num_documents; ++i){
+					tst::check(!errors[i], SL) << "i = " << i;
+					tst::check_eq(results[i], expected_result(i), SL);
+				}
+			}
+			tst::check_eq(num_handlers, num_threads, SL);
+		}
+	);
+
+	suite.add(
+		"errors",
+		[](){
+			std::vector<std::string_view> docs = {
+				"<a>ok</a>",
+				"<a>\n<b =/></a>",
+				"<a b='throw'/>",
+				"<a>&unknown;</a>",
+				"<a>ok again</a>"
+			};
+
+			std::vector<utki::span<const char>> spans;
+			for(const auto& d : docs){
+				spans.push_back(utki::make_span(d));
+			}
+
+			std::vector<std::string> results(docs.size());
+
+			mikroxml::batch_options options;
+			options.num_threads = 2;
+
+			mikroxml::batch_parser parser(
+				[&](){
+					return std::make_unique<handler>(results);
+				},
+				options
+			);
+
+			auto errors = parser.parse(utki::make_span(spans));
+
+			tst::check(!errors[0], SL);
+			tst::check_eq(results[0], std::string("<a>ok</a>"), SL);
+
+			try{
+				std::rethrow_exception(errors[1]);
+			}catch(mikroxml::malformed_xml& e){
+				tst::check_eq(e.line(), 2u, SL) << e.what();
+				tst::check_eq(e.column(), size_t(4), SL) << e.what();
+			}
+
+			try{
+				std::rethrow_exception(errors[2]);
+			}catch(std::runtime_error& e){
+				tst::check_eq(std::string(e.what()), std::string("handler error"), SL);
+			}
+
+			tst::check(bool(errors[3]), SL);
+			tst::check(results[3].empty(), SL);
+
+			tst::check(!errors[4], SL);
+			tst::check_eq(results[4], std::string("<a>ok again</a>"), SL);
+		}
+	);
+
+	suite.add(
+		"empty_batch",
+		[](){
+			std::vector<std::string> results;
+			mikroxml::batch_parser parser([&](){
+				return std::make_unique<handler>(results);
+			});
+			tst::check(parser.parse(utki::span<const utki::span<const char>>()).empty(), SL);
+		}
+	);
+});
+}
@@ -0,0 +1,229 @@
+#include <tst/set.hpp>
+#include <tst/check.hpp>
+
+#include <utki/string.hpp>
+
+#include "../../src/mikroxml/mikroxml.hpp"
+#include "../../src/mikroxml/parallel.hpp"
+
+#include <sstream>
+
+namespace{
+// prints content chunks as [chunk] and last chunks as [chunk|]
+class parser : public mikroxml::parser{
+	std::string merged_chunks;
+
+public:
+	std::stringstream ss;
+
+	// if true, the chunks of each content are printed as a single last chunk
+	bool merge_chunks = false;
+
+	parser() :
+		mikroxml::parser([](){
+			mikroxml::parser_options options;
+			options.stream_content = true;
+			return options;
+		}())
+	{}
+
+	void on_attribute_parsed(utki::span<const char> name, utki::span<const char> value) override{
+		ss << " " << name << "='" << value << "'";
+	}
+
+	void on_element_end(utki::span<const char> name) override{
+		if(name.size() == 0){
+			ss << "/>";
+		}else{
+			ss << "</" << name << ">";
+		}
+	}
+
+	void on_attributes_end(bool is_empty_element) override{
+		if(!is_empty_element){
+			ss << ">";
+		}
+	}
+
+	void on_element_start(utki::span<const char> name) override{
+		ss << '<' << name;
+	}
+
+	void on_content_parsed(utki::span<const char> str) override{
+		tst::check(false, SL) << "on_content_parsed() called in content streaming mode";
+	}
+
+	void on_content_chunk(utki::span<const char> chunk, bool is_last) override{
+		if(!this->merge_chunks){
+			ss << '[' << chunk << (is_last ? "|]" : "]");
+			return;
+		}
+
+		this->merged_chunks.append(chunk.data(), chunk.size());
+		if(is_last){
+			ss << '[' << this->merged_chunks << "|]";
+			this->merged_chunks.clear();
+		}
+	}
+};
+
+// counts content events of the default on_content_chunk() implementation
+class default_chunk_parser : public mikroxml::basic_parser<default_chunk_parser>{
+	friend class mikroxml::basic_parser<default_chunk_parser>;
+
+	void on_element_start(utki::span<const char> name){}
+
+	void on_element_end(utki::span<const char> name){}
+
+	void on_attributes_end(bool is_empty_element){}
+
+	void on_attribute_parsed(utki::span<const char> name, utki::span<const char> value){}
+
+	void on_content_parsed(utki::span<const char> str){
+		this->content.append(str.data(), str.size());
+		++this->num_content_events;
+	}
+
+public:
+	std::string content;
+	unsigned num_content_events = 0;
+
+	default_chunk_parser() :
+		mikroxml::basic_parser<default_chunk_parser>([](){
+			mikroxml::parser_options options;
+			options.stream_content = true;
+			return options;
+		}())
+	{}
+};
+}
+
+namespace{
+// NOLINTNEXTLINE(cppcoreguidelines-interfaces-global-init)
+const tst::set set("content_streaming", [](tst::suite& suite){
+	suite.add(
+		"chunks_end_at_feed_boundaries",
+		[](){
+			parser p;
+			p.feed(std::string("<a>abc"));
+			p.feed(std::string("def"));
+			p.feed(std::string("ghi</a>"));
+			p.end();
+			tst::check_eq(p.ss.str(), std::string("<a>[abc][def][ghi|]</a>"), SL);
+		}
+	);
+
+	suite.add(
+		"last_chunk_can_be_empty",
+		[](){
+			parser p;
+			p.feed(std::string("<a>abc"));
+			p.feed(std::string("</a>"));
+			p.end();
+			tst::check_eq(p.ss.str(), std::string("<a>[abc][|]</a>"), SL);
+		}
+	);
+
+	suite.add(
+		"character_references",
+		[](){
+			parser p;
+			p.feed(std::string("<a>a&am"));
+			p.feed(std::string("p;b&lt;c"));
+			p.feed(std::string("\r\nd</a>"));
+			p.end();
+			tst::check_eq(p.ss.str(), std::string("<a>[a][&b<c][\nd|]</a>"), SL);
+		}
+	);
+
+	suite.add(
+		"cdata",
+		[](){
+			parser p;
+			p.feed(std::string("<a><![CDATA[abc"));
+			p.feed(std::string("def]"));
+			p.feed(std::string("]>text</a>"));
+			p.end();
+			tst::check_eq(p.ss.str(), std::string("<a>[abc][def|][text|]</a>"), SL);
+		}
+	);
+
+	suite.add(
+		"trailing_content_is_closed",
+		[](){
+			parser p;
+			p.feed(std::string("<root>x</root>\n"));
+			p.end();
+			tst::check_eq(p.ss.str(), std::string("<root>[x|]</root>[\n][|]"), SL);
+		}
+	);
+
+	suite.add<std::pair<std::string_view, std::string_view>>(
+		"unterminated_content_same_as_parse_document",
+		{
+			{"<root>x</root>\n", "<root>[x|]</root>[\n|]"},
+			{"<root>x</root>\r\n", "<root>[x|]</root>[\n|]"},
+			{"<a>abc", "<a>[abc|]"},
+			{"<a>abc&amp;d&l", "<a>[abc&d|]"},
+			{"<a/>&amp;", "<a/>[&|]"},
+			{"<a><![CDATA[ab]", "<a>[ab]|]"},
+			{"<a><![CDATA[ab]]", "<a>[ab]]|]"},
+			{"<a>b</a>", "<a>[b|]</a>"}
+		},
+		[](const auto& p){
+			parser whole;
+			whole.merge_chunks = true;
+			whole.feed(utki::make_span(p.first));
+			whole.end();
+			tst::check_eq(whole.ss.str(), std::string(p.second), SL);
+
+			parser bytewise;
+			bytewise.merge_chunks = true;
+			for(const auto& c : p.first){
+				bytewise.feed(utki::make_span(&c, 1));
+			}
+			bytewise.end();
+			tst::check_eq(bytewise.ss.str(), std::string(p.second), SL);
+
+			parser document;
+			document.parse_document(utki::make_span(p.first));
+			tst::check_eq(document.ss.str(), std::string(p.second), SL);
+		}
+	);
+
+	suite.add(
+		"parse_document_reports_whole_content",
+		[](){
+			const std::string_view doc = "<a b='c'>abc&amp;def<![CDATA[cdata]]></a>";
+			const std::string expected = "<a b='c'>[abc&def|][cdata|]</a>";
+
+			{
+				parser p;
+				p.parse_document(utki::make_span(doc));
+				tst::check_eq(p.ss.str(), expected, SL);
+			}
+
+			{
+				parser p;
+				mikroxml::parallel_options parallel_options;
+				parallel_options.num_threads = 2;
+				parallel_options.chunk_size = 4;
+				mikroxml::parse_document_parallel(p, utki::make_span(doc), parallel_options);
+				tst::check_eq(p.ss.str(), expected, SL);
+			}
+		}
+	);
+
+	suite.add(
+		"default_on_content_chunk",
+		[](){
+			default_chunk_parser p;
+			p.feed(std::string("<a>abc"));
+			p.feed(std::string("def</a>"));
+			p.end();
+			tst::check_eq(p.content, std::string("abcdef"), SL);
+			tst::check_eq(p.num_content_events, 2u, SL);
+		}
+	);
+});
+}
@@ -0,0 +1,125 @@
+#include <tst/set.hpp>
+#include <tst/check.hpp>
+
+#include "../../src/mikroxml/document.hpp"
+
+#include <sstream>
+
+namespace{
+void print(std::stringstream& ss, const mikroxml::document& doc, mikroxml::document::node_id n){
+	switch(doc.type(n)){
+		case mikroxml::document::node_type::content:
+			ss << doc.content(n);
+			return;
+		case mikroxml::document::node_type::element:
+			ss << '<' << doc.name(n);
+			for(const auto& a : doc.attributes(n)){
+				ss << " " << a.name << "='" << a.value << "'";
+			}
+			ss << '>';
+			break;
+		case mikroxml::document::node_type::root:
+			break;
+	}
+
+	for(auto c = doc.first_child(n); c != mikroxml::document::null_node; c = doc.next_sibling(c)){
+		tst::check_eq(doc.parent(c), n, SL);
+		print(ss, doc, c);
+	}
+
+	if(doc.type(n) == mikroxml::document::node_type::element){
+		ss << "</" << doc.name(n) << '>';
+	}
+}
+
+std::string to_string(const mikroxml::document& doc){
+	std::stringstream ss;
+	print(ss, doc, doc.root());
+	return ss.str();
+}
+}
+
+namespace{
+// NOLINTNEXTLINE(cppcoreguidelines-interfaces-global-init)
+const tst::set set("document", [](tst::suite& suite){
+	suite.add<std::pair<std::string_view, std::string_view>>(
+			"parse",
+			{
+				{"", ""},
+				{"<a/>", "<a></a>"},
+				{"<?xml version='1.0'?><!-- comment --><a b='c' d=\"e\">text<f/>more<g h='&amp;'>&lt;</g></a>\n",
+						"<a b='c' d='e'>text<f></f>more<g h='&'><</g></a>"},
+				{"<!DOCTYPE x [ <!ENTITY e \"entity value\"> ]><a b='&e;'><![CDATA[cdata]]>&e;</a>",
+						"<a b='entity value'>cdataentity value</a>"},
+				{"<a><b><c/></b>unterminated", "<a><b><c></c></b></a>"},
+				{"<a/></b></a><c/>", "<a></a><c></c>"}
+			},
+			[](const auto& p){
+				auto doc = mikroxml::document::parse(utki::make_span(p.first));
+				tst::check_eq(to_string(doc), std::string(p.second), SL);
+			}
+		);
+
+	suite.add(
+		"builder_fed_in_pieces",
+		[](){
+			std::string_view data = "<root attr='value'><item id='1'>first</item><item id='2'>second</item></root>";
+
+			mikroxml::document_builder builder;
+			for(size_t i = 0; i < data.size(); i += 3){
+				builder.feed(data.substr(i, 3));
+			}
+			builder.end();
+
+			auto doc = builder.release();
+
+			tst::check_eq(
+					to_string(doc),
+					std::string("<root attr='value'><item id='1'>first</item><item id='2'>second</item></root>"),
+					SL
+				);
+
+			// the builder is left with an empty document
+			tst::check_eq(builder.release().size(), size_t(1), SL);
+		}
+	);
+
+	suite.add(
+		"navigation",
+		[](){
+			std::string_view data = "<root><item id='1' name='first'/><item id='2'/>text</root>";
+			auto doc = mikroxml::document::parse(utki::make_span(data));
+
+			tst::check_eq(doc.size(), size_t(5), SL);
+
+			auto root = doc.first_child(doc.root());
+			tst::check(doc.type(root) == mikroxml::document::node_type::element, SL);
+			tst::check_eq(doc.name(root), std::string_view("root"), SL);
+			tst::check_eq(doc.next_sibling(root), mikroxml::document::null_node, SL);
+			tst::check_eq(doc.parent(root), doc.root(), SL);
+
+			auto first = doc.first_child(root);
+			tst::check_eq(doc.attributes(first).size(), size_t(2), SL);
+
+			auto name = doc.find_attribute(first, "name");
+			tst::check(name != nullptr, SL);
+			tst::check_eq(name->value, std::string_view("first"), SL);
+			tst::check(doc.find_attribute(first, "unknown") == nullptr, SL);
+
+			auto second = doc.next_sibling(first);
+			tst::check_eq(doc.attributes(second).size(), size_t(1), SL);
+			tst::check_eq(doc.first_child(second), mikroxml::document::null_node, SL);
+
+			auto text = doc.next_sibling(second);
+			tst::check(doc.type(text) == mikroxml::document::node_type::content, SL);
+			tst::check_eq(doc.content(text), std::string_view("text"), SL);
+			tst::check_eq(doc.name(text), std::string_view(), SL);
+			tst::check_eq(doc.attributes(text).size(), size_t(0), SL);
+
+			// moving the document keeps the strings valid
+			auto moved = std::move(doc);
+			tst::check_eq(moved.content(text), std::string_view("text"), SL);
+		}
+	);
+});
+}
@@ -0,0 +1,260 @@
+#include <tst/set.hpp>
+#include <tst/check.hpp>
+
+#include <utki/string.hpp>
+
+#include <fsif/native_file.hpp>
+
+#include "../../src/mikroxml/mikroxml.hpp"
+#include "../../src/mikroxml/parallel.hpp"
+
+#include <sstream>
+#include <tuple>
+
+namespace{
+const std::string data_dir = "samples_data/";
+
+class parser : public mikroxml::parser{
+public:
+	std::stringstream ss;
+
+	parser() :
+		mikroxml::parser([](){
+			mikroxml::parser_options options;
+			options.detect_encoding = true;
+			return options;
+		}())
+	{}
+
+	void on_attribute_parsed(utki::span<const char> name, utki::span<const char> value) override{
+		this->ss << " " << name << "=\"" << value << "\"";
+	}
+
+	void on_element_end(utki::span<const char> name) override{
+		if(name.size() != 0){
+			this->ss << "</" << name << ">";
+		}
+	}
+
+	void on_attributes_end(bool is_empty_element) override{
+		this->ss << (is_empty_element ? "/>" : ">");
+	}
+
+	void on_element_start(utki::span<const char> name) override{
+		this->ss << '<' << name;
+	}
+
+	void on_content_parsed(utki::span<const char> str) override{
+		this->ss << str;
+	}
+};
+
+std::string to_utf16(std::string_view utf8, bool is_big_endian){
+	std::u32string code_points;
+	for(size_t i = 0; i != utf8.size();){
+		auto c = uint8_t(utf8[i]);
+		size_t length = c < 0x80 ? 1 : c < 0xe0 ? 2 : c < 0xf0 ? 3 : 4;
+		char32_t code_point = length == 1 ? c : c & (0xff >> (length + 1));
+		for(size_t j = 1; j != length; ++j){
+			code_point = (code_point << 6) | (uint8_t(utf8[i + j]) & 0x3f);
+		}
+		code_points.push_back(code_point);
+		i += length;
+	}
+
+	std::string ret;
+	auto append_unit = [&](char32_t unit){
+		if(is_big_endian){
+			ret.push_back(char(unit >> 8));
+			ret.push_back(char(unit & 0xff));
+		}else{
+			ret.push_back(char(unit & 0xff));
+			ret.push_back(char(unit >> 8));
+		}
+	};
+	for(auto c : code_points){
+		if(c < 0x10000){
+			append_unit(c);
+		}else{
+			append_unit(0xd800 + ((c - 0x10000) >> 10));
+			append_unit(0xdc00 + ((c - 0x10000) & 0x3ff));
+		}
+	}
+	return ret;
+}
+
+std::string decode(std::string_view data, size_t piece_size){
+	mikroxml::decoder d;
+	std::string ret;
+	for(size_t i = 0; i < data.size(); i += piece_size){
+		auto piece = data.substr(i, piece_size);
+		auto decoded = d.decode(utki::make_span(piece));
+		ret.append(decoded.data(), decoded.size());
+	}
+	auto decoded = d.decode(utki::span<const char>(), true);
+	ret.append(decoded.data(), decoded.size());
+	return ret;
+}
+
+std::string load(const std::string& file_name){
+	auto data = fsif::native_file(data_dir + file_name).load();
+	return utki::make_string(utki::to_char(utki::make_span(data)));
+}
+
+// removes the UTF-8 byte order mark
+std::string strip_bom(std::string str){
+	if(str.compare(0, 3, "\xef\xbb\xbf") == 0){
+		str.erase(0, 3);
+	}
+	return str;
+}
+}
+
+namespace{
+// NOLINTNEXTLINE(cppcoreguidelines-interfaces-global-init)
+const tst::set set("encoding", [](tst::suite& suite){
+	suite.add<std::tuple<std::string, mikroxml::encoding, std::string>>(
+		"detect_and_decode",
+		{
+			{"", mikroxml::encoding::utf8, ""},
+			{"<", mikroxml::encoding::utf8, "<"},
+			{"<a>\xc3\xa9</a>", mikroxml::encoding::utf8, "<a>\xc3\xa9</a>"},
+			{"\xef\xbb\xbf<a/>", mikroxml::encoding::utf8, "<a/>"},
+			{"<?xml version='1.0'?><a/>", mikroxml::encoding::utf8, "<?xml version='1.0'?><a/>"},
+			{"<?xml encoding = \"UTF-8\"?><a/>", mikroxml::encoding::utf8, "<?xml encoding = \"UTF-8\"?><a/>"},
+			{"<?xml encoding='ISO-8859-1'?><a>\xe9</a>", mikroxml::encoding::latin1, "<?xml encoding='ISO-8859-1'?><a>\xc3\xa9</a>"},
+			{
+				"<?xml encoding=\"latin1\"?><a>0123456789abcdef\xa0\xff" "0123456789abcdef</a>",
+				mikroxml::encoding::latin1,
+				"<?xml encoding=\"latin1\"?><a>0123456789abcdef\xc2\xa0\xc3\xbf" "0123456789abcdef</a>"
+			},
+			// the byte order mark takes precedence over the declaration
+			{"\xef\xbb\xbf<?xml encoding='ISO-8859-1'?><a>\xc3\xa9</a>", mikroxml::encoding::utf8, "<?xml encoding='ISO-8859-1'?><a>\xc3\xa9</a>"},
+			{std::string("\xff\xfe<\0a\0/\0>\0", 10), mikroxml::encoding::utf16le, "<a/>"},
+			{std::string("\xfe\xff\0<\0a\0/\0>", 10), mikroxml::encoding::utf16be, "<a/>"},
+			{std::string("<\0?\0x\0m\0l\0?\0>\0", 14), mikroxml::encoding::utf16le, "<?xml?>"},
+			{std::string("\0<\0?\0x\0m\0l\0?\0>", 14), mikroxml::encoding::utf16be, "<?xml?>"},
+			// unpaired surrogates and incomplete code unit
+			{std::string("\xff\xfe\x00\xd8<\0\x00\xdc\x00\xd8", 11), mikroxml::encoding::utf16le, "\xef\xbf\xbd<\xef\xbf\xbd\xef\xbf\xbd\xef\xbf\xbd"},
+		},
+		[](const auto& p){
+			const auto& [input, expected_encoding, expected] = p;
+			for(size_t piece_size : {size_t(1), size_t(2), size_t(3), input.size() + 1}){
+				tst::check_eq(decode(input, piece_size), expected, SL) << "piece_size = " << piece_size;
+			}
+
+			mikroxml::decoder d;
+			d.decode(utki::make_span(input), true);
+			tst::check(d.get_encoding() == expected_encoding, SL);
+		}
+	);
+
+	suite.add(
+		"utf16_long_text",
+		[](){
+			// mix of ASCII blocks, multi-byte characters and surrogate pairs at various offsets
+			std::string utf8 = "<a>";
+			for(unsigned i = 0; i != 100; ++i){
+				utf8.append(i % 37, 'x').append("\xc3\xa9").append(i % 5, 'y').append("\xe2\x82\xac\xf0\x9f\x98\x80");
+			}
+			utf8.append("</a>");
+
+			for(bool is_big_endian : {false, true}){
+				auto utf16 = std::string(is_big_endian ? "\xfe\xff" : "\xff\xfe") + to_utf16(utf8, is_big_endian);
+				for(size_t piece_size : {size_t(1), size_t(3), size_t(64), utf16.size()}){
+					tst::check_eq(decode(utf16, piece_size), utf8, SL) << "piece_size = " << piece_size << ", is_big_endian = " << is_big_endian;
+				}
+			}
+		}
+	);
+
+	suite.add(
+		"unsupported_encoding",
+		[](){
+			mikroxml::decoder d;
+			try{
+				d.decode(utki::make_span(std::string_view("<?xml version='1.0' encoding='EBCDIC'?><a/>")), true);
+				tst::check(false, SL) << "no exception thrown";
+			}catch(std::invalid_argument& e){
+				tst::check(std::string(e.what()).find("EBCDIC") != std::string::npos, SL) << e.what();
+			}
+		}
+	);
+
+	suite.add(
+		"from_name",
+		[](){
+			tst::check(mikroxml::decoder::from_name("Utf-8") == mikroxml::encoding::utf8, SL);
+			tst::check(mikroxml::decoder::from_name("iso-8859-1") == mikroxml::encoding::latin1, SL);
+			tst::check(mikroxml::decoder::from_name("UTF-16") == mikroxml::encoding::utf16be, SL);
+			tst::check(mikroxml::decoder::from_name("UTF-16LE") == mikroxml::encoding::utf16le, SL);
+			tst::check(mikroxml::decoder::from_name("UTF-8 ") == mikroxml::encoding::unknown, SL);
+			tst::check(mikroxml::decoder::from_name("") == mikroxml::encoding::unknown, SL);
+		}
+	);
+
+	suite.add<std::pair<std::string, std::string>>(
+		"parse_samples",
+		{
+			{"latintest_latin1.xml", "latintest_utf8.xml.cmp"},
+			{"latintest_utf8.xml", "latintest_utf8.xml.cmp"},
+			{"utftest_utf8_bom.xml", "utftest_utf8_bom.xml.cmp"},
+			{"utftest_utf8.xml", "utftest_utf8.xml.cmp"},
+		},
+		[](const auto& p){
+			auto in_data = load(p.first);
+			auto expected = strip_bom(load(p.second));
+
+			std::vector<std::string> inputs = {
+				in_data,
+				to_utf16("\xef\xbb\xbf" + strip_bom(in_data), false),
+				to_utf16("\xef\xbb\xbf" + strip_bom(in_data), true),
+			};
+			if(p.first == "latintest_latin1.xml"){
+				// the Latin-1 input cannot be converted to UTF-16 as is
+				inputs.resize(1);
+			}
+
+			for(const auto& in : inputs){
+				{
+					parser pp;
+					for(size_t i = 0; i < in.size(); i += 255){
+						pp.feed(utki::make_span(in.data() + i, std::min(in.size() - i, size_t(255))));
+					}
+					pp.end();
+					tst::check_eq(pp.ss.str(), expected, SL) << p.first;
+				}
+				{
+					parser pp;
+					pp.parse_document(utki::make_span(in));
+					tst::check_eq(pp.ss.str(), expected, SL) << p.first;
+				}
+				{
+					parser pp;
+					mikroxml::parallel_options parallel_options;
+					parallel_options.num_threads = 2;
+					parallel_options.chunk_size = 64;
+					mikroxml::parse_document_parallel(pp, utki::make_span(in), parallel_options);
+					tst::check_eq(pp.ss.str(), expected, SL) << p.first;
+				}
+			}
+		}
+	);
+
+	suite.add(
+		"parser_reports_encoding",
+		[](){
+			parser p;
+			tst::check(p.input_encoding() == mikroxml::encoding::unknown, SL);
+			p.feed(std::string("<?xml version='1.0' encoding='ISO-8859-1'?>"));
+			p.feed(std::string("<a b='\xe9'>\xe9</a>"));
+			p.end();
+			tst::check(p.input_encoding() == mikroxml::encoding::latin1, SL);
+			tst::check_eq(p.ss.str(), std::string("<a b=\"\xc3\xa9\">\xc3\xa9</a>"), SL);
+
+			p.reset();
+			tst::check(p.input_encoding() == mikroxml::encoding::unknown, SL);
+		}
+	);
+});
+}
@@ -0,0 +1,305 @@
+#include <tst/set.hpp>
+#include <tst/check.hpp>
+
+#include <utki/string.hpp>
+
+#include "../../src/mikroxml/mikroxml.hpp"
+#include "../../src/mikroxml/parallel.hpp"
+
+#include <sstream>
+
+namespace{
+class parser : public mikroxml::parser{
+public:
+	std::stringstream ss;
+
+	std::vector<std::string> content;
+
+	parser(const mikroxml::parser_options& options) :
+		mikroxml::parser(options)
+	{}
+
+	void on_attribute_parsed(utki::span<const char> name, utki::span<const char> value) override{
+		ss << " " << name << "='" << value << "'";
+	}
+
+	void on_element_end(utki::span<const char> name) override{
+		if(name.size() == 0){
+			ss << "/>";
+		}else{
+			ss << "</" << name << ">";
+		}
+	}
+
+	void on_attributes_end(bool is_empty_element) override{
+		if(!is_empty_element){
+			ss << ">";
+		}
+	}
+
+	void on_element_start(utki::span<const char> name) override{
+		ss << '<' << name;
+	}
+
+	void on_content_parsed(utki::span<const char> str) override{
+		ss << str;
+		this->content.emplace_back(str.data(), str.size());
+	}
+};
+
+enum class mode{
+	feed,
+	feed_by_byte,
+	parse_document,
+	parallel
+};
+
+const std::vector<mode> modes = {mode::feed, mode::feed_by_byte, mode::parse_document, mode::parallel};
+
+void parse(parser& p, mode m, std::string_view doc){
+	switch(m){
+		case mode::feed:
+			p.feed(utki::make_span(doc));
+			p.end();
+			break;
+		case mode::feed_by_byte:
+			for(auto c : doc){
+				p.feed(utki::make_span(&c, 1));
+			}
+			p.end();
+			break;
+		case mode::parse_document:
+			p.parse_document(utki::make_span(doc));
+			break;
+		case mode::parallel:
+			{
+				mikroxml::parallel_options parallel_options;
+				parallel_options.num_threads = 2;
+				parallel_options.chunk_size = 4;
+				mikroxml::parse_document_parallel(p, utki::make_span(doc), parallel_options);
+			}
+			break;
+	}
+}
+
+// returns true if the document is parsed within the limits
+bool is_within_limits(std::string_view doc, const mikroxml::parser_limits& limits){
+	mikroxml::parser_options options;
+	options.limits = limits;
+
+	bool ret = true;
+	for(auto m : modes){
+		parser p(options);
+		bool is_parsed = true;
+		try{
+			parse(p, m, doc);
+		}catch(mikroxml::malformed_xml&){
+			is_parsed = false;
+		}
+
+		if(m != modes.front()){
+			tst::check_eq(is_parsed, ret, SL) << "mode = " << unsigned(m) << ", doc = " << doc;
+		}
+		ret = is_parsed;
+	}
+	return ret;
+}
+}
+
+namespace{
+// NOLINTNEXTLINE(cppcoreguidelines-interfaces-global-init)
+const tst::set set("limits", [](tst::suite& suite){
+	suite.add(
+		"max_token_length",
+		[](){
+			mikroxml::parser_limits limits;
+			limits.max_token_length = 5;
+
+			tst::check(is_within_limits("<a>12345</a>", limits), SL);
+			tst::check(!is_within_limits("<a>123456</a>", limits), SL);
+			tst::check(is_within_limits("<a>1&amp;345</a>", limits), SL);
+			tst::check(!is_within_limits("<a>1&amp;&amp;456</a>", limits), SL);
+			tst::check(is_within_limits("<a b='12345'/>", limits), SL);
+			tst::check(!is_within_limits("<a b='123456'/>", limits), SL);
+			tst::check(is_within_limits("<a><![CDATA[12345]]></a>", limits), SL);
+			tst::check(!is_within_limits("<a><![CDATA[123456]]></a>", limits), SL);
+			tst::check(!is_within_limits("<!DOCTYPE a [<!ENTITY e \"123456\">]><a/>", limits), SL);
+		}
+	);
+
+	suite.add(
+		"max_name_length",
+		[](){
+			mikroxml::parser_limits limits;
+			limits.max_name_length = 3;
+
+			tst::check(is_within_limits("<abc def='1'>text</abc>", limits), SL);
+			tst::check(!is_within_limits("<abcd/>", limits), SL);
+			tst::check(!is_within_limits("<a defg='1'/>", limits), SL);
+			tst::check(!is_within_limits("<a></abcd>", limits), SL);
+			tst::check(!is_within_limits("<!DOCTYPE a [<!ENTITY abcd \"1\">]><a/>", limits), SL);
+		}
+	);
+
+	suite.add(
+		"max_ref_length",
+		[](){
+			mikroxml::parser_limits limits;
+			limits.max_ref_length = 3;
+
+			tst::check(is_within_limits("<a b='&lt;'>&amp;&#65;</a>", limits), SL);
+			tst::check(!is_within_limits("<a>&quot;</a>", limits), SL);
+			tst::check(!is_within_limits("<a b='&#x41;'/>", limits), SL);
+			tst::check(!is_within_limits("<a>&ampampampampamp", limits), SL);
+		}
+	);
+
+	suite.add<std::pair<std::string_view, size_t>>(
+		"max_ref_length_error_position",
+		{
+			{"<a>&ampampampampamp;</a>", 7},
+			{"<a>&ampampampampamp", 7},
+			{"<a>&ampa", 7},
+			{"<a b='&#x41;'/>", 10},
+			{"<a>text</a>\n&quot;", 16}
+		},
+		[](const auto& p){
+			mikroxml::parser_options options;
+			options.limits.max_ref_length = 3;
+
+			for(auto m : modes){
+				parser pp(options);
+				try{
+					parse(pp, m, p.first);
+					tst::check(false, SL) << "no exception thrown, mode = " << unsigned(m);
+				}catch(mikroxml::malformed_xml& e){
+					tst::check_eq(e.offset(), p.second, SL) << "mode = " << unsigned(m) << ", what = " << e.what();
+				}
+			}
+		}
+	);
+
+	suite.add(
+		"max_depth",
+		[](){
+			mikroxml::parser_limits limits;
+			limits.max_depth = 2;
+
+			tst::check(is_within_limits("<a><b/><b></b></a><a><b>text</b></a>", limits), SL);
+			tst::check(!is_within_limits("<a><b><c/></b></a>", limits), SL);
+			tst::check(!is_within_limits("<a><b></b><b><c></c></b></a>", limits), SL);
+		}
+	);
+
+	suite.add(
+		"max_depth_parallel_long_document",
+		[](){
+			constexpr unsigned depth = 100;
+			std::string doc;
+			for(unsigned i = 0; i != depth; ++i){
+				doc.append("<a>\n");
+			}
+			for(unsigned i = 0; i != depth; ++i){
+				doc.append("</a>\n");
+			}
+
+			mikroxml::parser_options options;
+			options.limits.max_depth = depth;
+
+			mikroxml::parallel_options parallel_options;
+			parallel_options.num_threads = 2;
+			parallel_options.chunk_size = 16;
+
+			{
+				parser p(options);
+				mikroxml::parse_document_parallel(p, utki::make_span(doc), parallel_options);
+			}
+
+			options.limits.max_depth = depth - 1;
+			parser p(options);
+			try{
+				mikroxml::parse_document_parallel(p, utki::make_span(doc), parallel_options);
+				tst::check(false, SL) << "no exception thrown";
+			}catch(mikroxml::malformed_xml& e){
+				tst::check(std::string(e.what()).find("line: 100") != std::string::npos, SL) << e.what();
+			}
+		}
+	);
+
+	suite.add(
+		"max_doctype_entities",
+		[](){
+			mikroxml::parser_limits limits;
+			limits.max_doctype_entities = 2;
+
+			tst::check(is_within_limits("<!DOCTYPE a [<!ENTITY b \"1\"><!ENTITY c \"2\"><!ENTITY b \"3\">]><a/>", limits), SL);
+			tst::check(!is_within_limits("<!DOCTYPE a [<!ENTITY b \"1\"><!ENTITY c \"2\"><!ENTITY d \"3\">]><a/>", limits), SL);
+		}
+	);
+
+	suite.add(
+		"max_entity_expansion",
+		[](){
+			mikroxml::parser_limits limits;
+			limits.max_entity_expansion = 9;
+
+			tst::check(is_within_limits("<!DOCTYPE a [<!ENTITY b \"123\">]><a c='&b;'>&b;&lt;&b;</a>", limits), SL);
+			tst::check(!is_within_limits("<!DOCTYPE a [<!ENTITY b \"123\">]><a c='&b;'>&b;&b;&b;</a>", limits), SL);
+		}
+	);
+
+	suite.add<std::pair<std::string_view, std::vector<std::string>>>(
+		"split_content",
+		{
+			{"<a>0123456789</a>", {"0123", "4567", "89"}},
+			{"<a>01234567</a>", {"0123", "4567"}},
+			{"<a>0123</a>", {"0123"}},
+			{"<a>01&amp;3456</a>", {"01&3", "456"}},
+			{"<a><![CDATA[0123456789]]></a>", {"0123", "4567", "89"}},
+			{"<a>ab\xc3\xa9" "cd</a>", {"ab\xc3\xa9", "cd"}},
+			{"<a>abc\xc3\xa9" "d</a>", {"abc", "\xc3\xa9" "d"}},
+			{"<a>\xf0\x9f\x98\x80" "\xf0\x9f\x98\x80</a>", {"\xf0\x9f\x98\x80", "\xf0\x9f\x98\x80"}},
+
+			// the last piece of the content which is not terminated by markup is not reported
+			{"<r></r>abcdef", {"abcd"}},
+			{"<r>0123456789", {"0123", "4567"}},
+			{"<r>01234567", {"0123"}},
+			{"<r>0123", {}},
+			{"<r>01&amp;3456&am", {"01&3"}},
+			{"<a><![CDATA[0123456789", {"0123", "4567"}},
+			{"<a><![CDATA[0123]]", {"0123"}},
+			{"<a><![CDATA[01]]", {}},
+		},
+		[](const auto& p){
+			mikroxml::parser_options options;
+			options.limits.max_token_length = 4;
+			options.limits.split_content = true;
+
+			for(auto m : modes){
+				parser pp(options);
+				parse(pp, m, p.first);
+
+				std::stringstream ss;
+				for(const auto& c : pp.content){
+					ss << " '" << c << "'";
+				}
+				tst::check(pp.content == p.second, SL) << "mode = " << unsigned(m) << ", got:" << ss.str();
+			}
+		}
+	);
+
+	suite.add(
+		"split_content_shorter_than_character",
+		[](){
+			mikroxml::parser_options options;
+			options.limits.max_token_length = 1;
+			options.limits.split_content = true;
+
+			parser p(options);
+			p.parse_document(utki::make_span(std::string_view("<a>\xc3\xa9</a>")));
+			tst::check_eq(p.content.size(), size_t(2), SL);
+			tst::check_eq(p.ss.str(), std::string("<a>\xc3\xa9</a>"), SL);
+		}
+	);
+});
+}
@@ -0,0 +1,177 @@
+#include <tst/set.hpp>
+#include <tst/check.hpp>
+
+#include <utki/string.hpp>
+
+#include "../../src/mikroxml/mikroxml.hpp"
+
+#include <array>
+#include <memory>
+#include <memory_resource>
+#include <sstream>
+
+namespace{
+class parser : public mikroxml::parser{
+public:
+	std::stringstream ss;
+
+	explicit parser(const mikroxml::parser_options& options) :
+		mikroxml::parser(options)
+	{}
+
+	void on_attribute_parsed(utki::span<const char> name, utki::span<const char> value) override{
+		ss << " " << name << "='" << value << "'";
+	}
+
+	void on_element_end(utki::span<const char> name) override{
+		if(name.size() == 0){
+			ss << "/>";
+		}else{
+			ss << "</" << name << ">";
+		}
+	}
+
+	void on_attributes_end(bool is_empty_element) override{
+		if(!is_empty_element){
+			ss << ">";
+		}
+	}
+
+	void on_element_start(utki::span<const char> name) override{
+		ss << '<' << name;
+	}
+
+	void on_content_parsed(utki::span<const char> str) override{
+		ss << str;
+	}
+};
+
+// forwards to the global heap, counting the allocations
+class counting_resource : public std::pmr::memory_resource{
+	void* do_allocate(size_t bytes, size_t alignment) override{
+		++this->num_allocations;
+		this->bytes_in_use += bytes;
+		return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+	}
+
+	void do_deallocate(void* p, size_t bytes, size_t alignment) override{
+		this->bytes_in_use -= bytes;
+		std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+	}
+
+	bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override{
+		return this == &other;
+	}
+
+public:
+	size_t num_allocations = 0;
+	size_t bytes_in_use = 0;
+};
+
+mikroxml::parser_options make_options(std::pmr::memory_resource* memory){
+	mikroxml::parser_options options;
+	options.memory = memory;
+	return options;
+}
+
+const std::string_view doctype_document =
+		"<!DOCTYPE a [<!ENTITY e \"entity\"><!ENTITY long \"entity which is too long for short string\">]>"
+		"<a b='&e;&amp;'>&long;&#x41;<![CDATA[cdata]]></a>";
+
+const std::string expected_events = "<a b='entity&'>entity which is too long for short stringAcdata</a>";
+}
+
+namespace{
+// NOLINTNEXTLINE(cppcoreguidelines-interfaces-global-init)
+const tst::set set("memory_resource", [](tst::suite& suite){
+	suite.add(
+		"buffers_are_allocated_from_resource",
+		[](){
+			counting_resource memory;
+			{
+				parser p(make_options(&memory));
+				tst::check(memory.num_allocations != 0, SL);
+
+				for(const auto& c : doctype_document){
+					p.feed(utki::make_span(&c, 1));
+				}
+				p.end();
+				tst::check_eq(p.ss.str(), expected_events, SL);
+
+				p.reset();
+				p.ss.str(std::string());
+				p.parse_document(utki::make_span(doctype_document));
+				tst::check_eq(p.ss.str(), expected_events, SL);
+			}
+			tst::check_eq(memory.bytes_in_use, size_t(0), SL);
+		}
+	);
+
+	suite.add(
+		"monotonic_buffer_without_upstream",
+		[](){
+			// the parsing fails with std::bad_alloc if anything is allocated elsewhere than in the buffer
+			constexpr size_t buffer_size = 0x10000;
+			std::array<char, buffer_size> buffer{};
+			std::pmr::monotonic_buffer_resource memory(buffer.data(), buffer.size(), std::pmr::null_memory_resource());
+
+			auto options = make_options(&memory);
+			options.detect_encoding = true;
+			parser p(options);
+
+			// UTF-16LE with byte order mark
+			std::string doc = "\xff\xfe";
+			for(char c : doctype_document){
+				doc.push_back(c);
+				doc.push_back('\0');
+			}
+
+			p.feed(utki::make_span(doc));
+			p.end();
+			tst::check_eq(p.ss.str(), expected_events, SL);
+		}
+	);
+
+	suite.add(
+		"move_assignment_between_resources",
+		[](){
+			counting_resource memory1;
+			counting_resource memory2;
+			{
+				auto p = std::make_unique<parser>(make_options(&memory1));
+				p->feed(utki::make_span(doctype_document.substr(0, doctype_document.size() / 2)));
+
+				parser other(make_options(&memory2));
+				other.feed(std::string("<x y='z"));
+				other = std::move(*p);
+				other.ss.str(std::string());
+
+				// the storage of the moved parser stays allocated from its own resource
+				tst::check(other.get_options().memory == &memory2, SL);
+				tst::check(p->get_options().memory == &memory1, SL);
+
+				// nothing refers to the moved-from parser
+				p.reset();
+
+				other.feed(utki::make_span(doctype_document.substr(doctype_document.size() / 2)));
+				other.end();
+				tst::check_eq(other.ss.str(), expected_events, SL);
+
+				other.ss.str(std::string());
+				other.feed(std::string("<a>&long;</a>"));
+				other.end();
+				tst::check_eq(other.ss.str(), std::string("<a>entity which is too long for short string</a>"), SL);
+
+				// new DOCTYPE entities are allocated from the parser's own resource
+				other.reset();
+				auto num_allocations = memory2.num_allocations;
+				other.feed(utki::make_span(doctype_document));
+				other.end();
+				tst::check(memory2.num_allocations != num_allocations, SL);
+			}
+			tst::check_eq(memory1.bytes_in_use, size_t(0), SL);
+			tst::check_eq(memory2.bytes_in_use, size_t(0), SL);
+		}
+	);
+});
+}
@@ -0,0 +1,180 @@
+#include <tst/set.hpp>
+#include <tst/check.hpp>
+
+#include <utki/string.hpp>
+
+#include "../../src/mikroxml/mikroxml.hpp"
+#include "../../src/mikroxml/parallel.hpp"
+#include "../../src/mikroxml/reader.hpp"
+
+#include <sstream>
+
+namespace{
+enum class name{
+	root,
+	item,
+	id,
+	value
+};
+
+const mikroxml::name_table names = {"root", "item", "id", "value"};
+
+// prints name ids instead of the known names
+class parser : public mikroxml::parser{
+public:
+	std::stringstream ss;
+
+	parser(const mikroxml::parser_options& options) :
+		mikroxml::parser(options)
+	{}
+
+	void print_name(utki::span<const char> name){
+		if(this->name_id() == mikroxml::name_table::unknown){
+			ss << name;
+		}else{
+			tst::check_eq(names.name(this->name_id()), std::string_view(name.data(), name.size()), SL);
+			ss << '#' << this->name_id();
+		}
+	}
+
+	void on_attribute_parsed(utki::span<const char> name, utki::span<const char> value) override{
+		ss << " ";
+		print_name(name);
+		ss << "='" << value << "'";
+	}
+
+	void on_element_end(utki::span<const char> name) override{
+		if(name.size() == 0){
+			tst::check_eq(this->name_id(), mikroxml::name_table::unknown, SL);
+			ss << "/>";
+		}else{
+			ss << "</";
+			print_name(name);
+			ss << ">";
+		}
+	}
+
+	void on_attributes_end(bool is_empty_element) override{
+		if(!is_empty_element){
+			ss << ">";
+		}
+	}
+
+	void on_element_start(utki::span<const char> name) override{
+		ss << '<';
+		print_name(name);
+	}
+
+	void on_content_parsed(utki::span<const char> str) override{
+		ss << str;
+	}
+};
+
+const std::string_view document = "<root id='1'><item id='2' other='3'>text</item><unknown value='4'/><item/></root>";
+const std::string_view expected = "<#0 #2='1'><#1 #2='2' other='3'>text</#1><unknown #3='4'/><#1/></#0>";
+}
+
+namespace{
+// NOLINTNEXTLINE(cppcoreguidelines-interfaces-global-init)
+const tst::set set("name_table", [](tst::suite& suite){
+	suite.add(
+		"find",
+		[](){
+			mikroxml::name_table table = {"a", "b", "a", "c"};
+
+			tst::check_eq(table.size(), size_t(3), SL);
+			tst::check_eq(table.find("a"), 0u, SL);
+			tst::check_eq(table.find("b"), 1u, SL);
+			tst::check_eq(table.find("c"), 2u, SL);
+			tst::check_eq(table.find("d"), mikroxml::name_table::unknown, SL);
+			tst::check_eq(table.find(""), mikroxml::name_table::unknown, SL);
+
+			tst::check_eq(table.add("c"), 2u, SL);
+			tst::check_eq(table.add("d"), 3u, SL);
+			tst::check_eq(table.name(3), "d", SL);
+
+			tst::check_eq(mikroxml::name_table().find("a"), mikroxml::name_table::unknown, SL);
+		}
+	);
+
+	suite.add(
+		"many_names",
+		[](){
+			mikroxml::name_table table;
+			constexpr unsigned num_names = 1000;
+			for(unsigned i = 0; i != num_names; ++i){
+				tst::check_eq(table.add("name" + std::to_string(i)), i, SL);
+			}
+			for(unsigned i = 0; i != num_names; ++i){
+				tst::check_eq(table.find("name" + std::to_string(i)), i, SL);
+			}
+			tst::check_eq(table.find("name1000"), mikroxml::name_table::unknown, SL);
+		}
+	);
+
+	suite.add(
+		"enum_ids",
+		[](){
+			tst::check_eq(names.find("value"), unsigned(name::value), SL);
+		}
+	);
+
+	suite.add(
+		"parser_reports_name_ids",
+		[](){
+			mikroxml::parser_options options;
+			options.names = &names;
+
+			{
+				parser p(options);
+				p.feed(document);
+				p.end();
+				tst::check_eq(p.ss.str(), std::string(expected), SL);
+			}
+
+			{
+				parser p(options);
+				p.parse_document(utki::make_span(document));
+				tst::check_eq(p.ss.str(), std::string(expected), SL);
+			}
+
+			{
+				parser p(options);
+				mikroxml::parallel_options parallel_options;
+				parallel_options.num_threads = 2;
+				parallel_options.chunk_size = 10;
+				mikroxml::parse_document_parallel(p, utki::make_span(document), parallel_options);
+				tst::check_eq(p.ss.str(), std::string(expected), SL);
+			}
+		}
+	);
+
+	suite.add(
+		"no_name_table",
+		[](){
+			parser p({});
+			p.feed(document);
+			p.end();
+			tst::check_eq(p.ss.str(), std::string(document), SL);
+		}
+	);
+
+	suite.add(
+		"reader_reports_name_ids",
+		[](){
+			mikroxml::parser_options options;
+			options.names = &names;
+
+			mikroxml::reader reader(utki::make_span(document), options);
+
+			auto e = reader.next();
+			tst::check(e.type == mikroxml::reader::event_type::start, SL);
+			tst::check_eq(e.name_id, unsigned(name::root), SL);
+
+			e = reader.next();
+			tst::check(e.type == mikroxml::reader::event_type::attr, SL);
+			tst::check_eq(e.name_id, unsigned(name::id), SL);
+		}
+	);
+});
+}
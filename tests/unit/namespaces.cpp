@@ -0,0 +1,198 @@
+#include <tst/set.hpp>
+#include <tst/check.hpp>
+
+#include <utki/string.hpp>
+
+#include "../../src/mikroxml/namespace_parser.hpp"
+
+#include <sstream>
+
+namespace{
+// prints the names as {namespace}local_name
+class parser : public mikroxml::namespace_parser{
+	void print_name(unsigned namespace_id, utki::span<const char> local_name){
+		if(namespace_id != mikroxml::namespace_resolver::no_namespace){
+			this->ss << '{' << this->namespace_name(namespace_id) << '}';
+		}
+		this->ss << local_name;
+	}
+
+public:
+	std::stringstream ss;
+
+	std::vector<unsigned> element_namespaces;
+
+	void on_element_start(unsigned namespace_id, utki::span<const char> local_name) override{
+		this->ss << '<';
+		this->print_name(namespace_id, local_name);
+		this->element_namespaces.push_back(namespace_id);
+	}
+
+	void on_element_end(unsigned namespace_id, utki::span<const char> local_name) override{
+		tst::check(!this->element_namespaces.empty(), SL);
+		tst::check_eq(namespace_id, this->element_namespaces.back(), SL);
+		this->element_namespaces.pop_back();
+
+		if(local_name.empty()){
+			return;
+		}
+		this->ss << "</";
+		this->print_name(namespace_id, local_name);
+		this->ss << '>';
+	}
+
+	void on_attributes_end(bool is_empty_element) override{
+		this->ss << (is_empty_element ? "/>" : ">");
+	}
+
+	void on_attribute_parsed(unsigned namespace_id, utki::span<const char> local_name, utki::span<const char> value) override{
+		this->ss << ' ';
+		this->print_name(namespace_id, local_name);
+		this->ss << "='" << value << "'";
+	}
+
+	void on_content_parsed(utki::span<const char> str) override{
+		this->ss << str;
+	}
+};
+
+// returns parsed events followed by the error message, if any
+std::string parse(std::string_view doc, bool by_byte){
+	parser p;
+	try{
+		if(by_byte){
+			for(auto c : doc){
+				p.feed(utki::make_span(&c, 1));
+			}
+			p.end();
+		}else{
+			p.parse_document(utki::make_span(doc));
+		}
+	}catch(mikroxml::malformed_xml& e){
+		p.ss << " error: " << e.what();
+	}
+	return p.ss.str();
+}
+}
+
+namespace{
+// NOLINTNEXTLINE(cppcoreguidelines-interfaces-global-init)
+const tst::set set("namespaces", [](tst::suite& suite){
+	suite.add<std::pair<std::string_view, std::string_view>>(
+		"resolve",
+		{
+			{"<a/>", "<a/>"},
+			{"<a b='c'>text</a>", "<a b='c'>text</a>"},
+			{
+				"<a xmlns='urn:d' xmlns:p='urn:p'><p:b p:x='1' y='2'/><c/></a>",
+				"<{urn:d}a {http://www.w3.org/2000/xmlns/}xmlns='urn:d' {http://www.w3.org/2000/xmlns/}p='urn:p'>"
+					"<{urn:p}b {urn:p}x='1' y='2'/><{urn:d}c/></{urn:d}a>"
+			},
+			// the declaration applies to the element and the attributes preceding it
+			{"<p:a p:b='1' xmlns:p='urn:p'/>", "<{urn:p}a {urn:p}b='1' {http://www.w3.org/2000/xmlns/}p='urn:p'/>"},
+			// redeclaration is in effect within the element only
+			{
+				"<p:a xmlns:p='urn:1'><p:b xmlns:p='urn:2'><p:c/></p:b><p:d/></p:a>",
+				"<{urn:1}a {http://www.w3.org/2000/xmlns/}p='urn:1'><{urn:2}b {http://www.w3.org/2000/xmlns/}p='urn:2'>"
+					"<{urn:2}c/></{urn:2}b><{urn:1}d/></{urn:1}a>"
+			},
+			// undeclaring the default namespace
+			{
+				"<a xmlns='urn:d'><b xmlns=''><c/></b><d/></a>",
+				"<{urn:d}a {http://www.w3.org/2000/xmlns/}xmlns='urn:d'><b {http://www.w3.org/2000/xmlns/}xmlns=''>"
+					"<c/></b><{urn:d}d/></{urn:d}a>"
+			},
+			{"<a xml:lang='en'/>", "<a {http://www.w3.org/XML/1998/namespace}lang='en'/>"},
+			// names without prefix or local part are unprefixed
+			{"<:a b:='1'/>", "<:a b:='1'/>"},
+			{"<a xmlns:p='urn:p'><p:b:c/></a>", "<a {http://www.w3.org/2000/xmlns/}p='urn:p'><{urn:p}b:c/></a>"},
+		},
+		[](const auto& p){
+			tst::check_eq(parse(p.first, false), std::string(p.second), SL);
+			tst::check_eq(parse(p.first, true), std::string(p.second), SL);
+		}
+	);
+
+	suite.add<std::pair<std::string_view, std::string_view>>(
+		"errors",
+		{
+			{"<p:a/>", "undeclared namespace prefix: p"},
+			{"<a p:b='1'/>", "undeclared namespace prefix: p"},
+			{"<a xmlns:p='urn:p'/><p:b/>", "undeclared namespace prefix: p"},
+			{"<a xmlns:p=''/>", "namespace prefix cannot be undeclared"},
+			{"<a xmlns:xmlns='urn:p'/>", "the xmlns prefix cannot be declared"},
+			{"<a xmlns:xml='urn:p'/>", "reserved namespace cannot be bound to prefix: xml"},
+			{"<a xmlns:p='http://www.w3.org/XML/1998/namespace'/>", "reserved namespace cannot be bound to prefix: p"},
+			{"<a xmlns='http://www.w3.org/2000/xmlns/'/>", "reserved namespace cannot be bound to prefix: "},
+		},
+		[](const auto& p){
+			for(bool by_byte : {false, true}){
+				auto result = parse(p.first, by_byte);
+				tst::check(result.find(p.second) != std::string::npos, SL) << "result = " << result;
+				tst::check(result.find("line: 1") != std::string::npos, SL) << "result = " << result;
+			}
+		}
+	);
+
+	suite.add(
+		"xml_prefix_can_be_declared",
+		[](){
+			tst::check_eq(
+				parse("<a xmlns:xml='http://www.w3.org/XML/1998/namespace' xml:lang='en'/>", false),
+				std::string(
+					"<a {http://www.w3.org/2000/xmlns/}xml='http://www.w3.org/XML/1998/namespace'"
+					" {http://www.w3.org/XML/1998/namespace}lang='en'/>"
+				),
+				SL
+			);
+		}
+	);
+
+	suite.add(
+		"namespace_ids",
+		[](){
+			parser p;
+			auto svg = p.add_namespace("http://www.w3.org/2000/svg");
+			auto xlink = p.add_namespace("http://www.w3.org/1999/xlink");
+			tst::check_eq(p.add_namespace("http://www.w3.org/2000/svg"), svg, SL);
+			tst::check_eq(p.namespace_name(svg), std::string_view("http://www.w3.org/2000/svg"), SL);
+			tst::check_eq(p.namespace_name(mikroxml::namespace_resolver::no_namespace), std::string_view(), SL);
+
+			p.parse_document(utki::make_span(std::string_view(
+				"<svg xmlns='http://www.w3.org/2000/svg' xmlns:xlink='http://www.w3.org/1999/xlink'>"
+				"<use xlink:href='#a'/></svg>"
+			)));
+
+			tst::check_eq(
+				p.ss.str(),
+				std::string(
+					"<{http://www.w3.org/2000/svg}svg {http://www.w3.org/2000/xmlns/}xmlns='http://www.w3.org/2000/svg'"
+					" {http://www.w3.org/2000/xmlns/}xlink='http://www.w3.org/1999/xlink'>"
+					"<{http://www.w3.org/2000/svg}use {http://www.w3.org/1999/xlink}href='#a'/></{http://www.w3.org/2000/svg}svg>"
+				),
+				SL
+			);
+
+			// the ids are kept after reset
+			p.reset();
+			tst::check_eq(p.add_namespace("http://www.w3.org/1999/xlink"), xlink, SL);
+		}
+	);
+
+	suite.add(
+		"reset_drops_scopes",
+		[](){
+			parser p;
+			p.feed(std::string("<p:a xmlns:p='urn:p'><p:b>"));
+			p.reset();
+			p.ss.str("");
+			p.element_namespaces.clear();
+
+			try{
+				p.parse_document(utki::make_span(std::string_view("<p:c/>")));
+				tst::check(false, SL) << "no exception thrown";
+			}catch(mikroxml::malformed_xml&){}
+		}
+	);
+});
+}
@@ -0,0 +1,118 @@
+#include <tst/set.hpp>
+#include <tst/check.hpp>
+
+#include <utki/string.hpp>
+
+#include "../../src/mikroxml/parallel.hpp"
+
+#include <sstream>
+
+namespace{
+class parser : public mikroxml::parser{
+public:
+	std::stringstream ss;
+
+	void on_attribute_parsed(utki::span<const char> name, utki::span<const char> value) override{
+		ss << " " << name << "='" << value << "'";
+	}
+
+	void on_element_end(utki::span<const char> name) override{
+		if(name.size() == 0){
+			ss << "/>";
+		}else{
+			ss << "</" << name << ">";
+		}
+	}
+
+	void on_attributes_end(bool is_empty_element) override{
+		if(!is_empty_element){
+			ss << ">";
+		}
+	}
+
+	void on_element_start(utki::span<const char> name) override{
+		ss << '<' << name;
+	}
+
+	void on_content_parsed(utki::span<const char> str) override{
+		ss << str;
+	}
+};
+
+std::string make_records(std::string_view record, unsigned num_records){
+	std::string ret = "<?xml version='1.0'?>\n<records>\n";
+	for(unsigned i = 0; i != num_records; ++i){
+		ret.append(record);
+	}
+	ret.append("</records>\n");
+	return ret;
+}
+
+std::string parse(const std::string& document, bool parallel, size_t chunk_size){
+	parser parser;
+	try{
+		if(parallel){
+			mikroxml::parallel_options options;
+			options.num_threads = 4;
+			options.chunk_size = chunk_size;
+			mikroxml::parse_document_parallel(parser, utki::make_span(document), options);
+		}else{
+			parser.feed(document);
+			parser.end();
+		}
+	}catch(mikroxml::malformed_xml& e){
+		parser.ss << " error: " << e.what();
+	}
+	return parser.ss.str();
+}
+}
+
+namespace{
+// NOLINTNEXTLINE(cppcoreguidelines-interfaces-global-init)
+const tst::set set("parallel", [](tst::suite& suite){
+	suite.add<std::string>(
+			"parallel_same_as_sequential",
+			{
+				make_records("<record id='1' name=\"x\">\n\t<value>some content &amp; more</value>\n</record>\n", 100),
+				make_records("<r a='attribute value with < and > inside'>text</r>", 100),
+				make_records("<r><!-- comment with <tags> inside <a> --></r>", 100),
+				make_records("<r><![CDATA[cdata with <tags> inside <a>]]></r>\n", 100),
+				make_records("<r/><?pi <with> <tags>?>", 100),
+				"<!DOCTYPE x [ <!ENTITY amp \"AMP\"> ]>" + make_records("<r>&amp;</r>\n", 100),
+				make_records("<r>text\r\n&#x41;</r>\n", 100) + "trailing",
+				make_records("<r>\n<a></a>\n</r>\n", 100) + "<r b=>",
+				make_records("<r>\n\n</r>", 100) + "<r><!-- unterminated <a>",
+				"<a>" + make_records("<r>&unknown;</r>\n", 1),
+				make_records("<r>\n</r>", 50) + "<r>&unknown;</r>" + make_records("<r>\n</r>", 50)
+			},
+			[](const auto& p){
+				auto expected = parse(p, false, 0);
+				for(size_t chunk_size : {1, 16, 50, 333, 100000}){
+					tst::check_eq(parse(p, true, chunk_size), expected, SL) << "chunk_size = " << chunk_size;
+				}
+			}
+		);
+
+	suite.add<size_t>(
+			"handler_state_is_not_used",
+			{1, 100000},
+			[](const auto& chunk_size){
+				// the DOCTYPE entities declared in the previously parsed document are kept by the handler
+				parser p;
+				p.feed(std::string("<!DOCTYPE a [<!ENTITY e \"entity\">]><a/>"));
+				p.end();
+				p.ss.str(std::string());
+
+				mikroxml::parallel_options options;
+				options.num_threads = 4;
+				options.chunk_size = chunk_size;
+				try{
+					mikroxml::parse_document_parallel(p, utki::make_span(std::string_view("<b>&e;</b>")), options);
+					tst::check(false, SL) << "no exception thrown";
+				}catch(mikroxml::malformed_xml&){}
+
+				tst::check_eq(p.ss.str(), std::string("<b>"), SL);
+			}
+		);
+});
+}
@@ -0,0 +1,174 @@
+#include <tst/set.hpp>
+#include <tst/check.hpp>
+
+#include <utki/string.hpp>
+
+#include "../../src/mikroxml/path_filter.hpp"
+
+#include <sstream>
+
+namespace{
+const std::string_view feed = R"(<?xml version="1.0"?>
+<feed id='f'>
+	<title>Feed</title>
+	<entry id='1'>
+		<title>First</title>
+		<id>urn:1</id>
+		<link href="http://example.com/1"/>
+		<content><p>text <b>bold</b></p><id>nested</id></content>
+	</entry>
+	<entry id='2'>
+		<id>urn:<!-- comment -->2</id>
+		<link rel="alternate" href="http://example.com/2"/>
+		<author><name>Author</name></author>
+	</entry>
+</feed>
+)";
+
+// prints the matches as "expression:type:name=value;"
+std::string filter(std::vector<std::string_view> expressions, std::string_view document = feed){
+	mikroxml::path_filter f(utki::make_span(expressions));
+
+	std::stringstream ss;
+	f.filter(
+		utki::make_span(document),
+		[&ss](const mikroxml::path_filter::match& m){
+			ss << m.expression << ':';
+			switch(m.type){
+				case mikroxml::path_filter::match_type::element:
+					ss << "element:" << m.name;
+					break;
+				case mikroxml::path_filter::match_type::content:
+					ss << "content:" << m.value;
+					break;
+				case mikroxml::path_filter::match_type::attribute:
+					ss << "attribute:" << m.name << '=' << m.value;
+					break;
+			}
+			ss << ';';
+		}
+	);
+	return ss.str();
+}
+}
+
+namespace{
+// NOLINTNEXTLINE(cppcoreguidelines-interfaces-global-init)
+const tst::set set("path_filter", [](tst::suite& suite){
+	suite.add<std::pair<std::vector<std::string_view>, std::string>>(
+		"filter",
+		{
+			{
+				{"/feed/entry/id"},
+				"0:element:id;0:content:urn:1;0:element:id;0:content:urn:;0:content:2;"
+			},
+			{
+				{"/feed/entry/link/@href"},
+				"0:attribute:href=http://example.com/1;0:attribute:href=http://example.com/2;"
+			},
+			{
+				{"/feed/entry/id", "/feed/entry/link/@href"},
+				"0:element:id;0:content:urn:1;1:attribute:href=http://example.com/1;"
+				"0:element:id;0:content:urn:;0:content:2;1:attribute:href=http://example.com/2;"
+			},
+			{
+				{"//id"},
+				"0:element:id;0:content:urn:1;0:element:id;0:content:nested;0:element:id;0:content:urn:;0:content:2;"
+			},
+			{
+				{"//@id"},
+				"0:attribute:id=f;0:attribute:id=1;0:attribute:id=2;"
+			},
+			{
+				{"/feed/*/title"},
+				"0:element:title;0:content:First;"
+			},
+			{
+				{"/feed//name"},
+				"0:element:name;0:content:Author;"
+			},
+			{
+				{"/feed/entry/link/@*"},
+				"0:attribute:href=http://example.com/1;0:attribute:rel=alternate;0:attribute:href=http://example.com/2;"
+			},
+			{
+				{"/feed/title"},
+				"0:element:title;0:content:Feed;"
+			},
+			{
+				{"/entry"},
+				""
+			},
+			{
+				// the same element is reported once for each matching expression
+				{"//entry//p", "/feed/entry/content/p"},
+				"0:element:p;1:element:p;0:content:text ;1:content:text ;"
+			},
+			{
+				// the element matching several states of the same expression is reported once
+				{"//*//b"},
+				"0:element:b;0:content:bold;"
+			}
+		},
+		[](const auto& p){
+			tst::check_eq(filter(p.first), p.second, SL);
+		}
+	);
+
+	suite.add<std::pair<std::vector<std::string_view>, std::string>>(
+		"descendant_attribute_includes_context_element",
+		{
+			{
+				{"/a//@id"},
+				"0:attribute:id=1;0:attribute:id=2;0:attribute:id=3;"
+			},
+			{
+				{"/a/b//@id"},
+				"0:attribute:id=2;0:attribute:id=3;"
+			},
+			{
+				{"//b//@id", "/a//@*"},
+				"1:attribute:id=1;0:attribute:id=2;1:attribute:id=2;0:attribute:id=3;1:attribute:id=3;1:attribute:x=y;"
+			}
+		},
+		[](const auto& p){
+			tst::check_eq(filter(p.first, "<a id='1'><b id='2'><c id='3'/></b><d x='y'/></a>"), p.second, SL);
+		}
+	);
+
+	suite.add<std::vector<std::string_view>>(
+		"malformed_document",
+		{
+			// the malformed part is inside of the element which can not produce any matches
+			{"/a/c"},
+			{"/a/b"}
+		},
+		[](const auto& p){
+			try{
+				filter(p, "<a><b><x =/></b><c>text</c></a>");
+				tst::check(false, SL) << "no exception thrown";
+			}catch(mikroxml::malformed_xml&){}
+		}
+	);
+
+	suite.add<std::string_view>(
+		"malformed_expression",
+		{
+			"",
+			"feed/entry",
+			"/",
+			"/feed//",
+			"/feed/@",
+			"/@id",
+			"/feed/@id/entry"
+		},
+		[](const auto& p){
+			try{
+				std::vector<std::string_view> expressions = {p};
+				mikroxml::path_filter f(utki::make_span(expressions));
+				tst::check(false, SL) << "no exception thrown for " << p;
+			}catch(std::invalid_argument&){}
+		}
+	);
+});
+}
@@ -0,0 +1,240 @@
+#include <tst/set.hpp>
+#include <tst/check.hpp>
+
+#include <utki/string.hpp>
+
+#include "../../src/mikroxml/mikroxml.hpp"
+#include "../../src/mikroxml/reader.hpp"
+
+#include <sstream>
+
+namespace{
+class parser : public mikroxml::parser{
+public:
+	std::stringstream ss;
+
+	void on_attribute_parsed(utki::span<const char> name, utki::span<const char> value) override{
+		ss << " " << name << "='" << value << "'";
+	}
+
+	void on_element_end(utki::span<const char> name) override{
+		if(name.size() == 0){
+			ss << "/>";
+		}else{
+			ss << "</" << name << ">";
+		}
+	}
+
+	void on_attributes_end(bool is_empty_element) override{
+		if(!is_empty_element){
+			ss << ">";
+		}
+	}
+
+	void on_element_start(utki::span<const char> name) override{
+		ss << '<' << name;
+	}
+
+	void on_content_parsed(utki::span<const char> str) override{
+		ss << str;
+	}
+};
+
+// formats the event the same way the parser above does
+void print(std::stringstream& ss, const mikroxml::reader::event& e){
+	using mikroxml::reader;
+	switch(e.type){
+		case reader::event_type::start:
+			ss << '<' << e.name;
+			break;
+		case reader::event_type::attr:
+			ss << " " << e.name << "='" << e.value << "'";
+			break;
+		case reader::event_type::attrs_end:
+			if(!e.is_empty_element){
+				ss << ">";
+			}
+			break;
+		case reader::event_type::content:
+			ss << e.value;
+			break;
+		case reader::event_type::end:
+			if(e.name.size() == 0){
+				ss << "/>";
+			}else{
+				ss << "</" << e.name << ">";
+			}
+			break;
+		case reader::event_type::end_of_document:
+			break;
+	}
+}
+
+std::string read_all(mikroxml::reader& r){
+	std::stringstream ss;
+	for(auto e = r.next(); e.type != mikroxml::reader::event_type::end_of_document; e = r.next()){
+		print(ss, e);
+	}
+	return ss.str();
+}
+}
+
+namespace{
+// NOLINTNEXTLINE(cppcoreguidelines-interfaces-global-init)
+const tst::set set("reader", [](tst::suite& suite){
+	suite.add<std::string_view>(
+			"reader_same_as_parser",
+			{
+				"<element attribute=\"attributeValue\">content</element>",
+				"<element attribute='attribute&amp;&lt;&gt;&quot;&apos;Value'>content&amp;&lt;&gt;&quot;&apos;</element>",
+				"<?xml version='1.0'?><!-- comment > --><a b='c>d'><![CDATA[cd>ata]]>x > y<d/></a>",
+				"<!DOCTYPE x [ <!ENTITY e \"first\"> ]><a b='&e;'>&e;\r\n&#x41;</a>",
+				"<a>\n\t<b c='d'/>\n</a>trailing",
+				"<a",
+				""
+			},
+			[](const auto& p){
+				parser parser;
+				parser.feed(p);
+				parser.end();
+
+				mikroxml::reader reader(utki::make_span(p));
+
+				tst::check_eq(read_all(reader), parser.ss.str(), SL);
+			}
+		);
+
+	suite.add<std::string_view>(
+			"events_before_error_same_as_parser",
+			{
+				"<a x='1'<&lt/\n=",
+				"<a><b c='d'>text</b><></a>",
+				"<a>text&unknown;</a>",
+				"<a b='c'></a></a><",
+			},
+			[](const auto& p){
+				parser parser;
+				std::string parser_error;
+				try{
+					parser.feed(p);
+					parser.end();
+				}catch(mikroxml::malformed_xml& e){
+					parser_error = e.what();
+				}
+
+				mikroxml::reader reader(utki::make_span(p));
+				std::stringstream ss;
+				std::string reader_error;
+				try{
+					for(auto e = reader.next(); e.type != mikroxml::reader::event_type::end_of_document; e = reader.next()){
+						print(ss, e);
+					}
+				}catch(mikroxml::malformed_xml& e){
+					reader_error = e.what();
+				}
+
+				tst::check_eq(ss.str(), parser.ss.str(), SL);
+				tst::check_eq(reader_error, parser_error, SL);
+
+				// the error is thrown once
+				tst::check(reader.next().type == mikroxml::reader::event_type::end_of_document, SL);
+			}
+		);
+
+	suite.add<std::pair<std::string_view, std::string_view>>(
+			"skip_subtree",
+			{
+				{"<r><a><b x='1>'>t&amp;</b><!-- </a> --><![CDATA[</a>]]><?pi </a>?><c/><c></c></a><g>text</g></r>",
+						"<r><g>text</g></r>"},
+				{"<r><a x='y' z=\"</a>\"><b/></a>\n<g/></r>",
+						"<r>\n<g/></r>"},
+				{"<r><a/><g/></r>",
+						"<r><g/></r>"},
+				{"<r><a>content > with gt<b></b> </a>after</r>",
+						"<r>after</r>"},
+				{"<r><a><b><c/></b>",
+						"<r>"}
+			},
+			[](const auto& p){
+				mikroxml::reader reader(utki::make_span(p.first));
+				std::stringstream ss;
+
+				for(auto e = reader.next(); e.type != mikroxml::reader::event_type::end_of_document; e = reader.next()){
+					if(e.type == mikroxml::reader::event_type::start && e.name.size() == 1 && e.name[0] == 'a'){
+						auto depth = reader.depth();
+						reader.skip_subtree();
+						tst::check_eq(reader.depth(), depth - 1, SL);
+						continue;
+					}
+					print(ss, e);
+				}
+
+				tst::check_eq(ss.str(), std::string(p.second), SL);
+			}
+		);
+
+	suite.add(
+		"skip_subtree_after_attributes",
+		[](){
+			std::string_view doc = "<r><a b='c'>text<x/></a><d>e</d></r>";
+			mikroxml::reader reader(utki::make_span(doc));
+
+			tst::check(reader.next().type == mikroxml::reader::event_type::start, SL);
+			tst::check(reader.next().type == mikroxml::reader::event_type::attrs_end, SL);
+			tst::check(reader.next().type == mikroxml::reader::event_type::start, SL);
+
+			auto attr = reader.next();
+			tst::check(attr.type == mikroxml::reader::event_type::attr, SL);
+			tst::check_eq(utki::make_string(attr.value), std::string("c"), SL);
+
+			tst::check(reader.next().type == mikroxml::reader::event_type::attrs_end, SL);
+
+			reader.skip_subtree();
+			tst::check_eq(reader.depth(), 1u, SL);
+
+			auto start = reader.next();
+			tst::check(start.type == mikroxml::reader::event_type::start, SL);
+			tst::check_eq(utki::make_string(start.name), std::string("d"), SL);
+		}
+	);
+
+	suite.add(
+		"skip_subtree_without_element_throws",
+		[](){
+			std::string_view doc = "<a/>";
+			mikroxml::reader reader(utki::make_span(doc));
+
+			bool thrown = false;
+			try{
+				reader.skip_subtree();
+			}catch(std::logic_error&){
+				thrown = true;
+			}
+			tst::check(thrown, SL);
+		}
+	);
+
+	suite.add(
+		"skip_subtree_keeps_line_number",
+		[](){
+			std::string_view doc = "<r>\n<a>\n<b>\n</b>\n</a>\n<c =";
+			mikroxml::reader reader(utki::make_span(doc));
+
+			reader.next();
+			reader.next();
+			reader.next();
+			reader.next();
+			reader.next();
+			reader.skip_subtree();
+
+			try{
+				while(reader.next().type != mikroxml::reader::event_type::end_of_document){}
+				tst::check(false, SL) << "exception expected";
+			}catch(mikroxml::malformed_xml& e){
+				std::string what = e.what();
+				tst::check(what.find("line: 6") != std::string::npos, SL) << "what = " << what;
+			}
+		}
+	);
+});
+}
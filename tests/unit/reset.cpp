@@ -0,0 +1,148 @@
+#include <tst/set.hpp>
+#include <tst/check.hpp>
+
+#include <utki/string.hpp>
+
+#include "../../src/mikroxml/mikroxml.hpp"
+
+#include <sstream>
+#include <vector>
+
+namespace{
+class parser : public mikroxml::parser{
+public:
+	std::stringstream ss;
+
+	void on_attribute_parsed(utki::span<const char> name, utki::span<const char> value) override{
+		ss << " " << name << "='" << value << "'";
+	}
+
+	void on_element_end(utki::span<const char> name) override{
+		if(name.size() == 0){
+			ss << "/>";
+		}else{
+			ss << "</" << name << ">";
+		}
+	}
+
+	void on_attributes_end(bool is_empty_element) override{
+		if(!is_empty_element){
+			ss << ">";
+		}
+	}
+
+	void on_element_start(utki::span<const char> name) override{
+		ss << '<' << name;
+	}
+
+	void on_content_parsed(utki::span<const char> str) override{
+		ss << str;
+	}
+
+	std::string take(){
+		auto ret = this->ss.str();
+		this->ss.str(std::string());
+		return ret;
+	}
+};
+
+const std::string_view doctype_document = "<!DOCTYPE a [<!ENTITY e \"entity\">]><a b='&e;'>&e;</a>";
+}
+
+namespace{
+// NOLINTNEXTLINE(cppcoreguidelines-interfaces-global-init)
+const tst::set set("reset", [](tst::suite& suite){
+	suite.add<std::string_view>(
+		"reset_in_the_middle_of_document",
+		{
+			"<a b='value",
+			"<a>content&am",
+			"<a><![CDATA[cdata]",
+			"<a><!-- comment -",
+			"<!DOCTYPE a [<!ENTITY e \"val",
+			"<a b",
+			"<"
+		},
+		[](const auto& p){
+			parser pp;
+			pp.feed(utki::make_span(p));
+			pp.reset();
+			pp.take();
+
+			pp.feed(utki::make_span(doctype_document));
+			pp.end();
+			tst::check_eq(pp.take(), std::string("<a b='entity'>entity</a>"), SL);
+		}
+	);
+
+	suite.add(
+		"reset_drops_doctype_entities",
+		[](){
+			parser p;
+			p.parse_document(utki::make_span(doctype_document));
+			p.reset();
+
+			try{
+				p.feed(std::string("<a>&e;</a>"));
+				tst::check(false, SL) << "no exception thrown";
+			}catch(mikroxml::malformed_xml& e){
+				// the position is counted from the beginning of the data fed after reset
+				tst::check_eq(e.line(), 1u, SL) << e.what();
+				tst::check_eq(e.offset(), size_t(5), SL) << e.what();
+			}
+		}
+	);
+
+	suite.add(
+		"reset_after_error",
+		[](){
+			parser p;
+			try{
+				p.feed(std::string("<a>\n<b =/>"));
+				tst::check(false, SL) << "no exception thrown";
+			}catch(mikroxml::malformed_xml&){
+			}
+			p.reset();
+			p.take();
+
+			p.feed(std::string("<a><b/></a>"));
+			p.end();
+			tst::check_eq(p.take(), std::string("<a><b/></a>"), SL);
+		}
+	);
+
+	suite.add(
+		"move_in_the_middle_of_document",
+		[](){
+			parser p;
+			p.feed(utki::make_span(doctype_document.substr(0, doctype_document.size() / 2)));
+
+			std::vector<parser> pool;
+			pool.push_back(std::move(p));
+			pool.reserve(pool.capacity() + 1); // relocate the parser once more
+
+			auto& moved = pool.front();
+			moved.feed(utki::make_span(doctype_document.substr(doctype_document.size() / 2)));
+			moved.end();
+			tst::check_eq(moved.take(), std::string("<a b='entity'>entity</a>"), SL);
+		}
+	);
+
+	suite.add(
+		"move_assignment",
+		[](){
+			parser p;
+			p.parse_document(utki::make_span(doctype_document));
+
+			parser other;
+			other.feed(std::string("<x y='z"));
+			other = std::move(p);
+			other.take();
+
+			other.feed(std::string("<a>&e;</a>"));
+			other.end();
+			tst::check_eq(other.take(), std::string("<a>entity</a>"), SL);
+		}
+	);
+});
+}
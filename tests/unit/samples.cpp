@@ -19,6 +19,10 @@ public:
 	std::vector<std::string> tagNameStack;
 	
 	std::stringstream ss;
+
+	parser(const mikroxml::parser_options& options = {}) :
+		mikroxml::parser(options)
+	{}
 	
 	void on_attribute_parsed(utki::span<const char> name, utki::span<const char> value) override{
 		this->ss << " " << name << "=\"" << value << "\"";
@@ -76,6 +80,75 @@ const tst::set set("samples", [](tst::suite& suite){
 			);
 	}
 
+    suite.add<std::string>(
+        "sample_zero_copy",
+        files,
+        [](const auto& p){
+            auto in_file_name = data_dir + p;
+
+            mikroxml::parser_options options;
+            options.zero_copy = true;
+
+            parser parser(options);
+
+            // feed whole file at once to let most of the tokens be reported without copying
+            auto in_data = fsif::native_file(in_file_name).load();
+            parser.feed(utki::make_span(in_data));
+            parser.end();
+            tst::check_eq(parser.tagNameStack.size(), size_t(0), SL);
+
+            auto out_string = parser.ss.str();
+
+            auto cmp_data = fsif::native_file(in_file_name + ".cmp").load();
+
+            tst::check(utki::deep_equals(to_uint8_t(utki::make_span(out_string)), utki::make_span(cmp_data)), SL)
+                << "parsed file is not as expected: " << in_file_name;
+        }
+    );
+
+    suite.add<std::string>(
+        "sample_parse_document",
+        files,
+        [](const auto& p){
+            auto in_file_name = data_dir + p;
+
+            parser parser;
+
+            auto in_data = fsif::native_file(in_file_name).load();
+            parser.parse_document(utki::to_char(utki::make_span(in_data)));
+            tst::check_eq(parser.tagNameStack.size(), size_t(0), SL);
+
+            auto out_string = parser.ss.str();
+
+            auto cmp_data = fsif::native_file(in_file_name + ".cmp").load();
+
+            tst::check(utki::deep_equals(to_uint8_t(utki::make_span(out_string)), utki::make_span(cmp_data)), SL)
+                << "parsed file is not as expected: " << in_file_name;
+        }
+    );
+
+    suite.add<std::string>(
+        "sample_structural_index",
+        files,
+        [](const auto& p){
+            auto in_file_name = data_dir + p;
+
+            parser parser;
+
+            auto in_data = fsif::native_file(in_file_name).load();
+            mikroxml::structural_index index(utki::to_char(utki::make_span(in_data)));
+            parser.parse_document(index);
+            tst::check_eq(parser.tagNameStack.size(), size_t(0), SL);
+
+            auto out_string = parser.ss.str();
+
+            auto cmp_data = fsif::native_file(in_file_name + ".cmp").load();
+
+            tst::check(utki::deep_equals(to_uint8_t(utki::make_span(out_string)), utki::make_span(cmp_data)), SL)
+                << "parsed file is not as expected: " << in_file_name;
+        }
+    );
+
     suite.add<std::string>(
         "sample",
         std::move(files),
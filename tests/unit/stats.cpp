@@ -0,0 +1,128 @@
+#include <tst/set.hpp>
+#include <tst/check.hpp>
+
+#include "../../src/mikroxml/mikroxml.hpp"
+
+namespace{
+class parser : public mikroxml::parser{
+public:
+	void on_attribute_parsed(utki::span<const char> name, utki::span<const char> value) override{}
+
+	void on_element_end(utki::span<const char> name) override{}
+
+	void on_attributes_end(bool is_empty_element) override{}
+
+	void on_element_start(utki::span<const char> name) override{}
+
+	void on_content_parsed(utki::span<const char> str) override{}
+};
+
+// 4 elements, 3 attributes, 3 contents, 2 named, 2 numeric and 2 DOCTYPE references
+const std::string_view document =
+		"<!DOCTYPE a [<!ENTITY e \"entity\">]>"
+		"<a b='&e;&amp;' c='&#x41;'>text&lt;&#65;<b/><c d='1'>&e;</c><![CDATA[cdata]]><d></d></a>";
+
+size_t total_state_steps(const mikroxml::parser_stats& stats){
+	size_t ret = 0;
+	for(const auto& n : stats.state_steps){
+		ret += n;
+	}
+	return ret;
+}
+
+void check_counters(bool use_feed){
+	parser p;
+	if(use_feed){
+		for(const auto& c : document){
+			p.feed(utki::make_span(&c, 1));
+		}
+		p.end();
+	}else{
+		p.parse_document(utki::make_span(document));
+	}
+
+	const auto& stats = p.stats();
+
+	if(!mikroxml::stats_enabled){
+		tst::check_eq(stats.bytes_fed, size_t(0), SL);
+		tst::check_eq(stats.num_elements, size_t(0), SL);
+		tst::check_eq(stats.peak_buf_capacity, size_t(0), SL);
+		tst::check_eq(total_state_steps(stats), size_t(0), SL);
+		tst::check(stats.parse_time == std::chrono::nanoseconds(0), SL);
+		return;
+	}
+
+	tst::check_eq(stats.bytes_fed, document.size(), SL);
+	tst::check_eq(stats.num_feed_calls, use_feed ? document.size() : size_t(0), SL);
+	tst::check_eq(stats.num_elements, size_t(4), SL);
+	tst::check_eq(stats.num_attributes, size_t(3), SL);
+	tst::check_eq(stats.num_contents, size_t(3), SL);
+	tst::check_eq(stats.num_named_refs, size_t(2), SL);
+	tst::check_eq(stats.num_numeric_refs, size_t(2), SL);
+	tst::check_eq(stats.num_doctype_refs, size_t(2), SL);
+	tst::check(stats.peak_buf_capacity != 0, SL);
+	tst::check(stats.peak_name_capacity != 0, SL);
+	tst::check(stats.peak_ref_char_buf_capacity != 0, SL);
+
+	tst::check(stats.parse_time > std::chrono::nanoseconds(0), SL);
+
+	if(use_feed){
+		tst::check(total_state_steps(stats) != 0, SL);
+		tst::check(stats.state_steps[0] != 0, SL) << "idle state steps";
+	}else{
+		tst::check_eq(total_state_steps(stats), size_t(0), SL);
+	}
+}
+}
+
+namespace{
+// NOLINTNEXTLINE(cppcoreguidelines-interfaces-global-init)
+const tst::set set("stats", [](tst::suite& suite){
+	suite.add(
+		"counters_feed",
+		[](){
+			check_counters(true);
+		}
+	);
+
+	suite.add(
+		"counters_parse_document",
+		[](){
+			check_counters(false);
+		}
+	);
+
+	suite.add(
+		"reset_zeroes_stats",
+		[](){
+			parser p;
+			p.feed(utki::make_span(document));
+			p.end();
+
+			p.reset();
+
+			const auto& stats = p.stats();
+			tst::check_eq(stats.bytes_fed, size_t(0), SL);
+			tst::check_eq(stats.num_feed_calls, size_t(0), SL);
+			tst::check_eq(stats.num_elements, size_t(0), SL);
+			tst::check_eq(stats.num_doctype_refs, size_t(0), SL);
+			tst::check_eq(stats.peak_buf_capacity, size_t(0), SL);
+			tst::check_eq(total_state_steps(stats), size_t(0), SL);
+			tst::check(stats.parse_time == std::chrono::nanoseconds(0), SL);
+		}
+	);
+
+	suite.add(
+		"state_names",
+		[](){
+			tst::check_eq(mikroxml::parser_stats::state_name(0), std::string_view("idle"), SL);
+			tst::check_eq(
+				mikroxml::parser_stats::state_name(mikroxml::parser_stats::num_states - 1),
+				std::string_view("cdata_terminator"),
+				SL
+			);
+			tst::check(mikroxml::parser_stats::state_name(mikroxml::parser_stats::num_states).empty(), SL);
+		}
+	);
+});
+}
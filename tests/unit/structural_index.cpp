@@ -0,0 +1,170 @@
+#include <tst/set.hpp>
+#include <tst/check.hpp>
+
+#include <utki/string.hpp>
+
+#include "../../src/mikroxml/mikroxml.hpp"
+
+#include <sstream>
+#include <vector>
+
+namespace{
+class parser : public mikroxml::parser{
+public:
+	std::stringstream ss;
+
+	void on_attribute_parsed(utki::span<const char> name, utki::span<const char> value) override{
+		ss << " " << name << "='" << value << "'";
+	}
+
+	void on_element_end(utki::span<const char> name) override{
+		if(name.size() == 0){
+			ss << "/>";
+		}else{
+			ss << "</" << name << ">";
+		}
+	}
+
+	void on_attributes_end(bool is_empty_element) override{
+		if(!is_empty_element){
+			ss << ">";
+		}
+	}
+
+	void on_element_start(utki::span<const char> name) override{
+		ss << '<' << name;
+	}
+
+	void on_content_parsed(utki::span<const char> str) override{
+		ss << '[' << str << ']';
+	}
+};
+
+// returns parsed events followed by the error message, if any
+std::string parse(std::string_view doc, bool use_index){
+	parser p;
+	try{
+		if(use_index){
+			mikroxml::structural_index index(utki::make_span(doc));
+			p.parse_document(index);
+		}else{
+			p.parse_document(utki::make_span(doc));
+		}
+	}catch(mikroxml::malformed_xml& e){
+		p.ss << " error: " << e.what();
+	}
+	return p.ss.str();
+}
+
+std::vector<uint32_t> to_vector(utki::span<const uint32_t> span){
+	return {span.begin(), span.end()};
+}
+}
+
+namespace{
+// NOLINTNEXTLINE(cppcoreguidelines-interfaces-global-init)
+const tst::set set("structural_index", [](tst::suite& suite){
+	suite.add(
+		"markup_and_escapes",
+		[](){
+			//                           0         1         2         3         4
+			//                           01234567890123456789012345678901234567890123456
+			const std::string_view doc = "<a b='>'>x&amp;\"<!-- <c> --><![CDATA[>]]></a>\r";
+			mikroxml::structural_index index(utki::make_span(doc));
+
+			tst::check(
+				to_vector(index.markup()) == std::vector<uint32_t>{0, 8, 16, 27, 28, 40, 41, 44},
+				SL
+			);
+			tst::check(to_vector(index.escapes()) == std::vector<uint32_t>{10, 45}, SL);
+		}
+	);
+
+	suite.add(
+		"unterminated_markup_is_not_indexed",
+		[](){
+			{
+				const std::string_view doc = "<a>text</a><b c='>";
+				mikroxml::structural_index index(utki::make_span(doc));
+				tst::check(to_vector(index.markup()) == std::vector<uint32_t>{0, 2, 7, 10}, SL);
+			}
+			{
+				const std::string_view doc = "<a>text<!-- comment";
+				mikroxml::structural_index index(utki::make_span(doc));
+				tst::check(to_vector(index.markup()) == std::vector<uint32_t>{0, 2}, SL);
+			}
+		}
+	);
+
+	suite.add<std::string_view>(
+		"same_events_as_parse_document",
+		{
+			"",
+			"text",
+			"<a/>",
+			"<a b='1' c=\"&lt;>\">content</a>",
+			"<a>\r\n&amp;&#x41;\r</a>",
+			"<a>\r</a>",
+			"<a>text&amp</a>",
+			"<a>&unknown;</a>",
+			"<?xml version=\"1.0\"?><a/>",
+			"<?xml?><a/>",
+			"<?a>b?><a/>",
+			"<a><!-- comment -->text</a>",
+			"<a><!-- comment --->text--></a>",
+			"<a><!-- > - -- --></a>",
+			"<a><![CDATA[<b>]]></a>",
+			"<a><![CDATA[]]]]></a>",
+			"<!DOCTYPE a><a/>",
+			"<!DOCTYPE a [<!ENTITY e \"x]>y\">]><a b='&e;'>&e;</a>",
+			"<!DOCTYPE a [<!ELEMENT a ANY>]><a/>",
+			"<!unknown><a/>",
+			"<a b='1'c='2'/>",
+			"<a b=1/>",
+			"<a \"b\"/>",
+			"<a <b>/>",
+			"<a></b>",
+			"<a>text",
+			"<a>text</a",
+			"<a b='>",
+			"<>",
+		},
+		[](const auto& p){
+			tst::check_eq(parse(p, true), parse(p, false), SL);
+		}
+	);
+
+	suite.add(
+		"long_document",
+		[](){
+			// the markup crosses the blocks the document is scanned by
+			std::string doc = "<root>";
+			for(unsigned i = 0; i != 100; ++i){
+				doc.append("<item id='").append(std::to_string(i)).append("' text=\"a > b\">");
+				doc.append(i, 'x').append("&amp;<!--").append(i % 70, '-').append("-->");
+				doc.append("<![CDATA[").append(i % 30, ']').append("]]></item>\n");
+			}
+			doc.append("</root>");
+
+			tst::check_eq(parse(doc, true), parse(doc, false), SL);
+		}
+	);
+
+	suite.add(
+		"index_is_reusable",
+		[](){
+			const std::string_view doc = "<a b='c'>text&amp;</a>";
+			mikroxml::structural_index index(utki::make_span(doc));
+
+			parser p1;
+			p1.parse_document(index);
+
+			parser p2;
+			p2.parse_document(index);
+
+			tst::check_eq(p1.ss.str(), std::string("<a b='c'>[text&]</a>"), SL);
+			tst::check_eq(p2.ss.str(), p1.ss.str(), SL);
+		}
+	);
+});
+}
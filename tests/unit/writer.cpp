@@ -0,0 +1,239 @@
+#include <tst/set.hpp>
+#include <tst/check.hpp>
+
+#include <utki/string.hpp>
+
+#include "../../src/mikroxml/mikroxml.hpp"
+#include "../../src/mikroxml/writer.hpp"
+
+#include <sstream>
+
+namespace{
+// prints the parsed events
+class parser : public mikroxml::parser{
+public:
+	std::stringstream ss;
+
+	void on_attribute_parsed(utki::span<const char> name, utki::span<const char> value) override{
+		ss << " " << name << "='" << value << "'";
+	}
+
+	void on_element_end(utki::span<const char> name) override{
+		ss << "</" << name << ">";
+	}
+
+	void on_attributes_end(bool is_empty_element) override{
+		ss << (is_empty_element ? "/>" : ">");
+	}
+
+	void on_element_start(utki::span<const char> name) override{
+		ss << '<' << name;
+	}
+
+	void on_content_parsed(utki::span<const char> str) override{
+		ss << '[' << str << ']';
+	}
+};
+
+// forwards the parsed events to the writer
+class echo_parser : public mikroxml::parser{
+public:
+	mikroxml::writer w;
+
+	void on_attribute_parsed(utki::span<const char> name, utki::span<const char> value) override{
+		this->w.attribute(name, value);
+	}
+
+	void on_element_end(utki::span<const char> name) override{
+		this->w.end_element();
+	}
+
+	void on_attributes_end(bool is_empty_element) override{}
+
+	void on_element_start(utki::span<const char> name) override{
+		this->w.start_element(name);
+	}
+
+	void on_content_parsed(utki::span<const char> str) override{
+		this->w.content(str);
+	}
+};
+
+std::string to_string(utki::span<const char> data){
+	return {data.data(), data.size()};
+}
+}
+
+namespace{
+// NOLINTNEXTLINE(cppcoreguidelines-interfaces-global-init)
+const tst::set set("writer", [](tst::suite& suite){
+	suite.add(
+		"elements",
+		[](){
+			mikroxml::writer w;
+			w.declaration();
+			w.start_element(utki::make_span("a"));
+			w.attribute(utki::make_span("b"), utki::make_span("c"));
+			w.start_element(utki::make_span("d"));
+			w.end_element();
+			w.content(utki::make_span("text"));
+			w.start_element(utki::make_span("e"));
+			w.content(utki::make_span("more"));
+			w.end_element();
+			tst::check_eq(w.depth(), size_t(1), SL);
+			w.end_element();
+			tst::check_eq(w.depth(), size_t(0), SL);
+
+			tst::check_eq(
+				to_string(w.data()),
+				std::string(R"(<?xml version="1.0" encoding="UTF-8"?><a b="c"><d/>text<e>more</e></a>)"),
+				SL
+			);
+		}
+	);
+
+	suite.add(
+		"escaping",
+		[](){
+			mikroxml::writer w;
+			w.start_element(utki::make_span("a"));
+			w.attribute(utki::make_span("b"), utki::make_span("1&2<3>4\"5'6\r7 long enough to be vectorized &"));
+			w.content(utki::make_span("1&2<3>4\"5'6\r7 long enough to be vectorized <"));
+			w.end_element();
+
+			tst::check_eq(
+				to_string(w.data()),
+				std::string(
+					"<a b=\"1&amp;2&lt;3&gt;4&quot;5&apos;6&#xD;7 long enough to be vectorized &amp;\">"
+					"1&amp;2&lt;3&gt;4\"5'6&#xD;7 long enough to be vectorized &lt;</a>"
+				),
+				SL
+			);
+		}
+	);
+
+	suite.add(
+		"pretty_printing",
+		[](){
+			mikroxml::writer_options options;
+			options.indent = "  ";
+
+			mikroxml::writer w(options);
+			w.declaration();
+			w.start_element(utki::make_span("a"));
+			w.start_element(utki::make_span("b"));
+			w.attribute(utki::make_span("c"), utki::make_span("d"));
+			w.end_element();
+			w.start_element(utki::make_span("e"));
+			w.content(utki::make_span("text"));
+			w.end_element();
+			w.start_element(utki::make_span("f"));
+			w.start_element(utki::make_span("g"));
+			w.end_element();
+			w.end_element();
+			w.end_element();
+
+			tst::check_eq(
+				to_string(w.data()),
+				std::string(
+					"<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+					"<a>\n"
+					"  <b c=\"d\"/>\n"
+					"  <e>text</e>\n"
+					"  <f>\n"
+					"    <g/>\n"
+					"  </f>\n"
+					"</a>"
+				),
+				SL
+			);
+		}
+	);
+
+	suite.add(
+		"sink",
+		[](){
+			std::vector<std::string> batches;
+
+			mikroxml::writer_options options;
+			options.flush_threshold = 16;
+
+			mikroxml::writer w(
+				[&batches](utki::span<const char> data){
+					batches.push_back(to_string(data));
+				},
+				options
+			);
+
+			for(unsigned i = 0; i != 10; ++i){
+				w.start_element(utki::make_span("item"));
+				w.content(utki::make_span("text"));
+				w.end_element();
+			}
+			tst::check(w.data().size() < options.flush_threshold, SL);
+			w.flush();
+			tst::check(w.data().empty(), SL);
+
+			std::string written;
+			for(size_t i = 0; i != batches.size(); ++i){
+				if(i + 1 != batches.size()){
+					tst::check(batches[i].size() >= options.flush_threshold, SL) << "i = " << i;
+				}
+				written += batches[i];
+			}
+
+			std::string expected;
+			for(unsigned i = 0; i != 10; ++i){
+				expected += "<item>text</item>";
+			}
+			tst::check_eq(written, expected, SL);
+		}
+	);
+
+	suite.add<std::string_view>(
+		"round_trip",
+		{
+			"<a/>",
+			"<a b='c' d=\"e\">text</a>",
+			"<a b='&quot;&apos;&amp;&lt;&gt;'>&amp;&lt;&gt;&quot;&apos;</a>",
+			"<a>line&#xD;\nline&#13;\n</a>",
+			"<a><![CDATA[<b>&amp;</b>]]></a>",
+			"<a><b><c/></b>text<d x='1'>more</d></a>",
+			"<a>\xd0\xbf\xd1\x80\xd0\xb8\xd0\xb2\xd0\xb5\xd1\x82 &#x20AC;</a>",
+		},
+		[](const auto& p){
+			parser original;
+			original.feed(p);
+			original.end();
+
+			echo_parser echo;
+			echo.feed(p);
+			echo.end();
+
+			parser written;
+			written.parse_document(echo.w.data());
+
+			tst::check_eq(written.ss.str(), original.ss.str(), SL) << "written: " << to_string(echo.w.data());
+		}
+	);
+
+	suite.add(
+		"misuse",
+		[](){
+			mikroxml::writer w;
+
+			try{
+				w.end_element();
+				tst::check(false, SL) << "no exception thrown";
+			}catch(std::logic_error&){}
+
+			w.start_element(utki::make_span("a"));
+			w.content(utki::make_span("text"));
+			try{
+				w.attribute(utki::make_span("b"), utki::make_span("c"));
+				tst::check(false, SL) << "no exception thrown";
+			}catch(std::logic_error&){}
+		}
+	);
+});
+}